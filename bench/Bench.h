@@ -0,0 +1,72 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// the helpers shared by the benchmarks, each benchmark is a standalone program printing its results.
+namespace simple_logger::bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // written by the benchmarks so the measured work is not optimized away.
+    inline volatile size_t g_sink = 0;
+
+    // the log directory of the benchmarks, the log creates its dated directory even if the file output is off,
+    // so the benchmarks keep it out of the current directory.
+    inline std::string GetBenchDir()
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "simple_logger_bench";
+        std::filesystem::create_directories(dir);
+        return dir.generic_string();
+    }
+
+    // run func count times, return the nanoseconds per call.
+    template <typename Func>
+    double MeasureNs(size_t count, Func&& func)
+    {
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / count;
+    }
+
+    inline double ElapsedMs(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // the value at the percentile in [0, 100] of the samples, the samples are sorted.
+    inline double Percentile(std::vector<double>& samples, double percentile)
+    {
+        if (samples.empty()) {
+            return 0;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        size_t index = static_cast<size_t>(percentile / 100 * (samples.size() - 1));
+        return samples[index];
+    }
+}
+
+#endif // !BENCH_H
@@ -0,0 +1,79 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the cost of the print micros on the log writing threads in the eager and the deferred format modes,
+// the user defined writer drops the logs, and the queue is unbounded, so the writing threads never wait for the
+// writer thread.
+class NullWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        g_sink = str.size();
+    }
+};
+
+static void Run(bool deferred, int threadCount)
+{
+    constexpr size_t COUNT = 200000;
+    Log log(GetBenchDir(), "deferred_format_bench", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), true, QueueType::Locked);
+    log.SetUserWriter(std::make_shared<NullWriter>());
+    log.SetDeferredFormat(deferred);
+
+    std::vector<double> producerNs(threadCount);
+    std::vector<std::thread> threads;
+    Clock::time_point begin = Clock::now();
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&log, &producerNs, t] {
+            std::string user = "user-" + std::to_string(t);
+            producerNs[t] = MeasureNs(COUNT, [&](size_t i) {
+                DBG_INFO(log, 0, "request {} from {} took {} ms, ratio {}", i, user, i % 1000, 0.5 * i);
+            });
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    log.Close();
+    double total = ElapsedMs(begin);
+    double average = 0;
+    for (double ns : producerNs) {
+        average += ns / threadCount;
+    }
+
+    printf("%-8s %d threads: %8.1f ns/call on the writing threads, %8.1f ms end to end for %zu logs\n",
+        deferred ? "deferred" : "eager", threadCount, average, total, COUNT * threadCount);
+}
+
+int main()
+{
+    for (int threadCount : { 1, 4 }) {
+        Run(false, threadCount);
+        Run(true, threadCount);
+    }
+
+    return 0;
+}
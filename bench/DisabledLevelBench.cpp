@@ -0,0 +1,55 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "Bench.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the cost of the print micros whose logs are rejected before formatting, by the level, the output flag and the
+// module level flag, compared with formatting the same arguments, which the disabled logs paid before.
+int main()
+{
+    constexpr size_t COUNT = 10000000;
+    constexpr int MODULE = 7;
+    std::string user = "alice";
+    double ratio = 0.75;
+
+    Log log(GetBenchDir(), "disabled_level_bench", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal));
+    log.SetModuleLevelFlag(MODULE, MakeFlag(LogLevel::Error));
+
+    double format = MeasureNs(COUNT, [&](size_t i) {
+        g_sink = FORMAT("user {} request {} ratio {}", user, i, ratio).size();
+    });
+    double level = MeasureNs(COUNT, [&](size_t i) {
+        DBG_DEBUG(log, 0, "user {} request {} ratio {}", user, i, ratio);
+    });
+    double module = MeasureNs(COUNT, [&](size_t i) {
+        DBG_INFO(log, MODULE, "user {} request {} ratio {}", user, i, ratio);
+    });
+    log.SetOutputTypeOff(OutputType::UserDefined);
+    double output = MeasureNs(COUNT, [&](size_t i) {
+        DBG_INFO(log, 0, "user {} request {} ratio {}", user, i, ratio);
+    });
+    log.Close();
+
+    printf("format the arguments only:  %8.2f ns/call\n", format);
+    printf("disabled by level:          %8.2f ns/call\n", level);
+    printf("disabled by module level:   %8.2f ns/call\n", module);
+    printf("disabled by output flag:    %8.2f ns/call\n", output);
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Bench.h"
+#include "LogEncoder.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the per character escaper, each byte is checked and appended by itself.
+static void AppendJsonEscapedNaive(std::string& out, std::string_view text)
+{
+    static const char HEX[] = "0123456789abcdef";
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+            case '"': out += "\\\""; ++i; continue;
+            case '\\': out += "\\\\"; ++i; continue;
+            case '\b': out += "\\b"; ++i; continue;
+            case '\f': out += "\\f"; ++i; continue;
+            case '\n': out += "\\n"; ++i; continue;
+            case '\r': out += "\\r"; ++i; continue;
+            case '\t': out += "\\t"; ++i; continue;
+            default: break;
+        }
+
+        if (c < 0x20) {
+            out += "\\u00";
+            out += HEX[c >> 4];
+            out += HEX[c & 0xF];
+            ++i;
+            continue;
+        }
+
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+            ++i;
+            continue;
+        }
+
+        size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 0;
+        uint32_t codePoint = length == 4 ? c & 0x07 : length == 3 ? c & 0x0F : c & 0x1F;
+        bool valid = length != 0 && i + length <= text.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            valid = (static_cast<unsigned char>(text[i + k]) & 0xC0) == 0x80;
+            codePoint = (codePoint << 6) | (text[i + k] & 0x3F);
+        }
+
+        const uint32_t minCodePoints[] = { 0, 0, 0x80, 0x800, 0x10000 };
+        if (valid && codePoint >= minCodePoints[length] && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF)) {
+            for (size_t k = 0; k < length; ++k) {
+                out += text[i + k];
+            }
+
+            i += length;
+        } else {
+            out += "\xEF\xBF\xBD";
+            ++i;
+        }
+    }
+}
+
+template <typename Escape>
+static double MeasureMBps(std::string_view text, Escape&& escape)
+{
+    constexpr size_t TOTAL_BYTES = 512 * 1024 * 1024;
+    size_t count = TOTAL_BYTES / text.size();
+    std::string out;
+    double ns = MeasureNs(count, [&](size_t) {
+        out.clear();
+        escape(out, text);
+        g_sink = out.size();
+    });
+
+    return text.size() / ns * 1e9 / 1048576;
+}
+
+static void Run(const char* name, const std::string& text)
+{
+    double naive = MeasureMBps(text, AppendJsonEscapedNaive);
+    double scalar = MeasureMBps(text, AppendJsonEscapedScalar);
+    double vector = MeasureMBps(text, AppendJsonEscaped);
+    printf("%-28s naive %7.0f MB/s, scalar %7.0f MB/s, SSE2/AVX2 %7.0f MB/s\n", name, naive, scalar, vector);
+}
+
+// the throughput of the JSON string escaping of the messages.
+int main()
+{
+    std::string message = "user 10086 logged in from 192.168.1.100, session 7f3a9c, took 35 ms, result ok.";
+    std::string longMessage;
+    while (longMessage.size() < 4096) {
+        longMessage += message + " ";
+    }
+
+    std::string quoted = "request {\"id\":10086,\"path\":\"C:\\\\logs\\\\app.log\"}\nstatus\t200";
+    std::string utf8 = "\xE7\x94\xA8\xE6\x88\xB7 10086 \xE7\x99\xBB\xE5\xBD\x95\xE6\x88\x90\xE5\x8A\x9F, \xE8\x80\x97\xE6\x97\xB6 35 ms \xF0\x9F\x98\x80";
+
+    Run("ASCII, 80 bytes", message);
+    Run("ASCII, 4 KB", longMessage);
+    Run("quotes and controls", quoted);
+    Run("UTF-8", utf8);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "FileWriter.h"
+#include "IoUringWriter.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// write totalBytes of 128 bytes logs through the writer, flushing every bufferSize bytes.
+static void Run(const char* name, IoUringWriter* ioUring, size_t bufferSize, size_t totalBytes)
+{
+    std::string filePath = GetBenchDir() + "/file_write_bench.log";
+    std::filesystem::remove(filePath);
+
+    std::string log(127, 'x');
+    log.push_back('\n');
+
+    FileWriter writer;
+    if (!writer.Open(filePath, ioUring)) {
+        printf("%s: can not open %s\n", name, filePath.c_str());
+        return;
+    }
+
+    // the time the writer thread spends in each flush, it is the time the thread is not taking logs.
+    std::vector<double> flushUs;
+    Clock::time_point begin = Clock::now();
+    for (size_t written = 0; written < totalBytes; written += log.size()) {
+        writer.Append(log);
+        if (writer.Size() % bufferSize < log.size()) {
+            Clock::time_point flushBegin = Clock::now();
+            writer.Flush();
+            flushUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - flushBegin).count());
+        }
+    }
+
+    writer.Close();
+    double elapsedMs = ElapsedMs(begin);
+    std::filesystem::remove(filePath);
+
+    printf("%-9s buffer %4zu KB: %7.1f MB/s, flush p50 %7.1f us, p99 %7.1f us\n", name, bufferSize / 1024,
+        totalBytes / 1048576.0 / (elapsedMs / 1000), Percentile(flushUs, 50), Percentile(flushUs, 99));
+}
+
+// the throughput of the log file and the time the writer thread is blocked by a flush,
+// with the write system call and with io_uring.
+int main()
+{
+    constexpr size_t TOTAL_BYTES = 256 * 1024 * 1024;
+    IoUringWriter ioUring;
+    bool hasIoUring = ioUring.Init();
+    for (size_t bufferSize : { 4 * 1024, 64 * 1024, 1024 * 1024 }) {
+        Run("write", nullptr, bufferSize, TOTAL_BYTES);
+        if (hasIoUring) {
+            Run("io_uring", &ioUring, bufferSize, TOTAL_BYTES);
+        }
+    }
+
+    if (!hasIoUring) {
+        printf("io_uring is not available, build with -DSIMPLE_LOGGER_IO_URING=ON on linux to compare it.\n");
+    }
+
+    return 0;
+}
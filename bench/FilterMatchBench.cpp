@@ -0,0 +1,75 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "AhoCorasick.h"
+#include "Bench.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the message of size bytes made of a log line repeated, it contains none of the filters.
+static std::string MakeMessage(size_t size)
+{
+    const std::string line = "2023-03-23 10:20:30.456 [Info] [network] [Connection.cpp(line: 120, method: OnRead, thread: 12345)]: "
+        "received 4096 bytes from 192.168.10.24:8080 on connection 77, pending requests 12, queue depth 3, "
+        "latency 1.25 ms, session id 9f8e7d6c5b4a, user agent simple-client/1.0 ";
+    std::string message;
+    while (message.size() < size) {
+        message.append(line, 0, std::min(line.size(), size - message.size()));
+    }
+
+    return message;
+}
+
+// matching a log message with the And/Or filters, by the automaton and by std::string::find per filter,
+// which is how the filters were matched before. none of the filters is found, so every filter is checked.
+int main()
+{
+    constexpr size_t BYTES = 10000000;
+    for (int filterCount : { 10, 50, 200 }) {
+        std::unordered_set<std::string> filters;
+        for (int i = 0; i < filterCount; ++i) {
+            filters.insert("error code " + std::to_string(i * 7919));
+        }
+
+        AhoCorasick matcher(filters);
+        for (size_t messageSize : { 64, 512, 4096 }) {
+            // about the same bytes are matched for each size.
+            size_t count = BYTES / messageSize;
+            std::string message = MakeMessage(messageSize);
+            double find = MeasureNs(count, [&](size_t) {
+                bool found = false;
+                for (const std::string& filter : filters) {
+                    if (message.find(filter) != std::string::npos) {
+                        found = true;
+                        break;
+                    }
+                }
+                g_sink = found;
+            });
+            double automaton = MeasureNs(count, [&](size_t) {
+                g_sink = matcher.MatchAny(message);
+            });
+
+            printf("%3d filters, %4zu bytes message: find per filter %9.1f ns, automaton %8.1f ns\n", filterCount,
+                message.size(), find, automaton);
+        }
+    }
+
+    return 0;
+}
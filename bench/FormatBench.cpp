@@ -0,0 +1,95 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "Bench.h"
+#include "Formatter.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the formatter used before when <format> is missing, every argument is written to a std::stringstream.
+namespace stream_format
+{
+    void FormatExpand(std::stringstream& ss, const char* fmt)
+    {
+        while (*fmt) {
+            if (*fmt == '{' && *(++fmt) == '}') {
+                throw std::logic_error("Invalid formatting: missing arguments");
+            }
+            ss << *fmt++;
+        }
+    }
+
+    template<typename T, typename... Args>
+    void FormatExpand(std::stringstream& ss, const char* fmt, T& value, Args... args)
+    {
+        while (*fmt) {
+            if (*fmt == '{' && *(++fmt) == '}') {
+                ss << value;
+                FormatExpand(ss, ++fmt, args...);
+                return;
+            }
+            ss << *fmt++;
+        }
+    }
+
+    template<typename ... Args>
+    std::string format(const char* fmt, Args ... args)
+    {
+        std::stringstream ss;
+        FormatExpand(ss, fmt, args...);
+        return ss.str();
+    }
+}
+
+// the cost of formatting typical log messages by FORMAT and by the stringstream formatter, FORMAT is the fallback
+// formatter if <format> is missing, otherwise it is std::format. AppendFormat reuses the capacity of its output.
+int main()
+{
+    constexpr size_t COUNT = 1000000;
+    std::string user = "alice";
+    const char* path = "/api/v1/orders";
+
+    double streamInt = MeasureNs(COUNT, [](size_t i) {
+        g_sink = stream_format::format("request {} done", i).size();
+    });
+    double formatInt = MeasureNs(COUNT, [](size_t i) {
+        g_sink = FORMAT("request {} done", i).size();
+    });
+
+    double streamMixed = MeasureNs(COUNT, [&](size_t i) {
+        g_sink = stream_format::format("user {} requested {} {} times, took {} ms, ok {}", user, path, i, 0.25 * i, i % 2 == 0).size();
+    });
+    double formatMixed = MeasureNs(COUNT, [&](size_t i) {
+        g_sink = FORMAT("user {} requested {} {} times, took {} ms, ok {}", user, path, i, 0.25 * i, i % 2 == 0).size();
+    });
+
+    printf("one integer,        stringstream: %8.1f ns, FORMAT: %8.1f ns\n", streamInt, formatInt);
+    printf("mixed 5 arguments,  stringstream: %8.1f ns, FORMAT: %8.1f ns\n", streamMixed, formatMixed);
+
+#ifndef HAS_STD_FORMAT
+    std::string out;
+    double append = MeasureNs(COUNT, [&](size_t i) {
+        out.clear();
+        AppendFormat(out, "user {} requested {} {} times, took {} ms, ok {}", user, path, i, 0.25 * i, i % 2 == 0);
+        g_sink = out.size();
+    });
+    printf("mixed 5 arguments,  AppendFormat to a reused string: %8.1f ns\n", append);
+#endif
+    return 0;
+}
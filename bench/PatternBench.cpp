@@ -0,0 +1,65 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "Bench.h"
+#include "LogFormatter.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+static double MeasureFormatNs(const LogPattern* pattern, bool detailMode)
+{
+    constexpr size_t COUNT = 2000000;
+    LogFormatter formatter;
+    LogRecord record;
+    record.time = GetCurrentTime();
+    record.moduleName = "net";
+    record.fileName = "/home/user/project/src/net/Server.cpp";
+    record.line = 128;
+    record.funcName = "Accept";
+    record.threadId = 12345;
+    record.threadName = "io-worker-3";
+    record.message = "user 10086 logged in from 192.168.1.100, session 7f3a9c, took 35 ms, result ok.";
+
+    std::string out;
+    return MeasureNs(COUNT, [&](size_t i) {
+        // a new millisecond every 1000 records, like a busy log.
+        record.time = Now(record.time.time_since_epoch() + std::chrono::milliseconds(i % 1000 == 0));
+        out.clear();
+        formatter.Format(record, { pattern, detailMode, LogEncoding::Text }, out);
+        g_sink = out.size();
+    });
+}
+
+// the cost of rendering a record by the default layout and by the compiled patterns, the first pattern produces
+// the same bytes as the default layout of the detail mode.
+int main()
+{
+    LogPattern detail("%Y-%m-%d %H:%M:%S.%e [%l] [%n] [%s(line: %#, method: %!, thread: %t/%w)]: %v");
+    LogPattern brief("%Y-%m-%d %H:%M:%S.%e [%l] [%n]: %v");
+    LogPattern split("%d/%m/%Y %H.%M.%S,%e %L %v");
+
+    printf("detail mode,   default layout: %6.1f ns, pattern: %6.1f ns\n", MeasureFormatNs(nullptr, true), MeasureFormatNs(&detail, true));
+    printf("brief mode,    default layout: %6.1f ns, pattern: %6.1f ns\n", MeasureFormatNs(nullptr, false), MeasureFormatNs(&brief, false));
+    printf("split date time fields pattern: %6.1f ns\n", MeasureFormatNs(&split, true));
+
+    double compile = MeasureNs(100000, [&](size_t) {
+        LogPattern pattern(detail.GetPattern());
+        g_sink = pattern.GetPattern().size();
+    });
+    printf("compile the detail pattern:     %6.1f ns\n", compile);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "Bench.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+constexpr size_t LOG_COUNT = 500000;
+
+// a user defined writer waiting on the network, each batch takes 2 ms.
+class SlowWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        (void)str;
+    }
+
+    void WriteBatch(std::span<const std::string_view> logs, std::span<const LogMetadata> metadata) override
+    {
+        (void)metadata;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        received += logs.size();
+    }
+
+    std::atomic<size_t> received = 0;
+};
+
+static size_t GetDirSize(const std::filesystem::path& dir)
+{
+    size_t size = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file(ec)) {
+            size += static_cast<size_t>(entry.file_size(ec));
+        }
+    }
+
+    return size;
+}
+
+// log LOG_COUNT logs and return the bytes of the log file, the time until all of them are in the log file is printed.
+// the slow writer is added if fileBytes is not 0, and fileBytes is the size of the log file when it is complete.
+static size_t Run(const char* name, OverflowPolicy policy, size_t fileBytes)
+{
+    std::filesystem::path dir = std::filesystem::path(GetBenchDir()) / "slow_sink_bench";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    auto writer = std::make_shared<SlowWriter>();
+    uint32_t outputFlag = fileBytes == 0 ? MakeFlag(OutputType::LogFile) : MakeFlag(OutputType::LogFile, OutputType::UserDefined);
+    Log log(dir.generic_string(), "slow_sink_bench.log", outputFlag, MakeFlag(LogLevel::Info), false);
+    log.SetUserWriter(writer);
+    log.SetSinkQueueLimit(OutputType::UserDefined, 4, policy);
+
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < LOG_COUNT; ++i) {
+        // the numbers have the same count of digits, so the logs have the same size in each run.
+        DBG_INFO(log, 0, "request {} is done, status {}", 1000000 + i, "ok");
+    }
+
+    double producerMs = ElapsedMs(begin);
+    if (fileBytes == 0) {
+        log.Close();
+        fileBytes = GetDirSize(dir);
+    } else {
+        while (GetDirSize(dir) < fileBytes && ElapsedMs(begin) < 60000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    double fileMs = ElapsedMs(begin);
+    printf("%-26s %8.1f ms to log, %8.1f ms until the log file is complete (%6.1f MB/s), %zu logs to the slow writer, %llu dropped\n",
+        name, producerMs, fileMs, fileBytes / 1048576.0 / (fileMs / 1000), writer->received.load(),
+        static_cast<unsigned long long>(log.GetSinkDroppedCount(OutputType::UserDefined)));
+
+    log.Close();
+    std::filesystem::remove_all(dir);
+    return fileBytes;
+}
+
+// the log file throughput with a slow user defined writer, each output terminal has its own thread and queue,
+// so the log file is not slowed down by the slow writer unless the writer blocks the dispatching when its queue is full.
+int main()
+{
+    size_t fileBytes = Run("file only", OverflowPolicy::Block, 0);
+    Run("slow writer, DropNewest", OverflowPolicy::DropNewest, fileBytes);
+    Run("slow writer, DropOldest", OverflowPolicy::DropOldest, fileBytes);
+    Run("slow writer, Block", OverflowPolicy::Block, fileBytes);
+    return 0;
+}
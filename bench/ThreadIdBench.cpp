@@ -0,0 +1,106 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Bench.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the numeric id of std::thread::id by a stringstream, which every log paid before the id is cached by the thread.
+static uint64_t ToNumericIdByStream(std::thread::id threadId)
+{
+    std::stringstream ss;
+    ss << threadId;
+    uint64_t id = 0;
+    ss >> id;
+    return id;
+}
+
+// the user defined writer drops the logs.
+class NullWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        g_sink = str.size();
+    }
+};
+
+enum class ThreadIdCase
+{
+    Stream,     // the id is converted by a stringstream for every log, like before it is cached.
+    Cached,
+    Named,      // the id is cached and the thread has a name.
+};
+
+// the cost of the print micro in detail mode, the log is written by its own thread, so the thread name is not left
+// to the other cases. the id of the other thread passed to Log::Write is not cached, so it is converted by a
+// stringstream for every log.
+static void RunWrite(ThreadIdCase idCase)
+{
+    constexpr size_t COUNT = 500000;
+    std::thread([idCase] {
+        Log log(GetBenchDir(), "thread_id_bench", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), true, QueueType::Locked);
+        log.SetUserWriter(std::make_shared<NullWriter>());
+        if (idCase == ThreadIdCase::Named) {
+            SetCurrentThreadName("io-worker-3");
+        }
+
+        std::thread::id otherId;
+        std::thread([&otherId] { otherId = std::this_thread::get_id(); }).join();
+        static const LogSource source{ __FILE__, __LINE__, __FUNCTION__, "request {} took {} ms" };
+
+        Clock::time_point begin = Clock::now();
+        double producer = MeasureNs(COUNT, [&](size_t i) {
+            if (idCase == ThreadIdCase::Stream) {
+                if (log.NeedWrite(LogLevel::Info, 0)) {
+                    log.Write(LogLevel::Info, 0, source, otherId, FORMAT("request {} took {} ms", i, i % 1000));
+                }
+            } else {
+                DBG_WRITE(log, LogLevel::Info, 0, "request {} took {} ms", i, i % 1000);
+            }
+        });
+        log.Close();
+        double total = ElapsedMs(begin);
+
+        const char* names[] = { "stringstream id", "cached id", "cached id and name" };
+        printf("Write in detail mode, %-18s: %8.1f ns/call on the writing thread, %8.1f ms end to end for %zu logs\n",
+            names[static_cast<int>(idCase)], producer, total, COUNT);
+    }).join();
+}
+
+// the cost of getting the numeric id of the current thread for a log, alone and through the whole Write.
+int main()
+{
+    constexpr size_t COUNT = 10000000;
+    double stream = MeasureNs(COUNT / 10, [](size_t) {
+        g_sink = ToNumericIdByStream(std::this_thread::get_id());
+    });
+    double cached = MeasureNs(COUNT, [](size_t) {
+        g_sink = GetCurrentThreadNumericId();
+    });
+
+    printf("stringstream of std::thread::id: %8.2f ns/call\n", stream);
+    printf("GetCurrentThreadNumericId:       %8.2f ns/call\n", cached);
+
+    RunWrite(ThreadIdCase::Stream);
+    RunWrite(ThreadIdCase::Cached);
+    RunWrite(ThreadIdCase::Named);
+    return 0;
+}
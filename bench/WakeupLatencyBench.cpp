@@ -0,0 +1,80 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <charconv>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace simple_logger::bench;
+
+// the latency from writing a log to the user defined writer receiving it, when the log writer thread is idle
+// between the logs, so every log has to wake it up. the message is the writing time in nanoseconds.
+class LatencyWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        int64_t received = Clock::now().time_since_epoch().count();
+        int64_t written = 0;
+        std::from_chars(str.data(), str.data() + str.size(), written);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_samples.push_back((received - written) / 1000.0);
+    }
+
+    std::vector<double> TakeSamples()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return std::move(m_samples);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<double> m_samples;
+};
+
+static void Run(int64_t maxWaitTimeMs, std::chrono::microseconds interval)
+{
+    constexpr int COUNT = 2000;
+    auto writer = std::make_shared<LatencyWriter>();
+    Log log(GetBenchDir(), "wakeup_latency_bench", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info));
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "%v");
+    log.SetMaxWaitTime(std::chrono::milliseconds(maxWaitTimeMs));
+    for (int i = 0; i < COUNT; ++i) {
+        std::this_thread::sleep_for(interval);
+        DBG_INFO(log, 0, "{}", Clock::now().time_since_epoch().count());
+    }
+
+    log.Close();
+    std::vector<double> samples = writer->TakeSamples();
+    printf("max wait %3lld ms, %5lld us between logs: p50 %8.1f us, p99 %8.1f us, max %8.1f us (%zu logs)\n",
+        static_cast<long long>(maxWaitTimeMs), static_cast<long long>(interval.count()), Percentile(samples, 50),
+        Percentile(samples, 99), Percentile(samples, 100), samples.size());
+}
+
+int main()
+{
+    // the writer parks on the condition variable between the logs, so the producer has to notify it.
+    Run(0, std::chrono::microseconds(1000));
+    Run(300, std::chrono::microseconds(1000));
+    // the writer is likely still spinning when the next log comes.
+    Run(0, std::chrono::microseconds(0));
+    return 0;
+}
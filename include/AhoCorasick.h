@@ -0,0 +1,59 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace simple_logger
+{
+    // multiple patterns substring matcher, the patterns are compiled into an automaton,
+    // so the text is scanned once regardless of the count of patterns.
+    // the matching functions are const and can be called by multiple threads.
+    class AhoCorasick
+    {
+    public:
+        AhoCorasick() = default;
+        explicit AhoCorasick(const std::unordered_set<std::string>& patterns);
+
+    public:
+        bool Empty() const;
+        // return true if any pattern is found in text.
+        bool MatchAny(std::string_view text) const;
+        // return true if all patterns are found in text.
+        bool MatchAll(std::string_view text) const;
+
+    private:
+        size_t m_patternCount = 0;
+        bool m_hasEmptyPattern = false;
+
+        // the bytes not used by any pattern share class 0, it keeps the transition table small.
+        // there are up to 257 classes when the patterns use all the bytes, so a class does not fit in uint8_t.
+        uint16_t m_byteClass[256] = { 0 };
+        size_t m_classCount = 1;
+
+        // row of state + class -> row of next state, the row of a state is state * m_classCount,
+        // and it is stored as ~row if any pattern ends at the next state, so the scanning loop needs one lookup per byte.
+        std::vector<int32_t> m_transitions;
+        std::vector<int32_t> m_patternIds;      // the pattern ends at the state, or -1.
+        std::vector<int32_t> m_outputLinks;     // the nearest suffix state where a pattern ends, or -1.
+    };
+}
+
+#endif // !AHO_CORASICK_H
@@ -0,0 +1,123 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ARGS_CODEC_H
+#define ARGS_CODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include "Formatter.h"
+
+// encode the formatting arguments into bytes on the log writing thread, and decode them to format on the log writer thread.
+// numbers and enums are copied as raw bytes, strings are copied with their length, pointers are copied as addresses,
+// and the other arguments are formatted to strings when they are encoded.
+namespace simple_logger
+{
+    // format the encoded arguments in data with fmt, and append the result to out.
+    using FormatFunc = void (*)(std::string_view fmt, const char* data, std::string& out);
+
+    template <typename... Args>
+    void FormatTo(std::string& out, std::string_view fmt, Args&... args)
+    {
+#ifdef HAS_STD_FORMAT
+        std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(args...));
+#else
+        AppendVFormat(out, fmt, args...);
+#endif
+    }
+
+    // T is a decayed type.
+    template <typename T>
+    struct ArgCodec
+    {
+        static constexpr bool IS_STRING = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>
+            || std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+        // only the numbers and the enums are copied as raw bytes, the other trivially copyable types like pointers and
+        // the structs holding pointers may refer to the memory which is freed before the writer thread formats them.
+        static constexpr bool IS_TRIVIAL = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+        // the pointers other than the C strings are copied as addresses and formatted like void*, they are not read.
+        static constexpr bool IS_ADDRESS = std::is_pointer_v<T> && !IS_STRING;
+
+        using Decoded = std::conditional_t<IS_TRIVIAL, T, std::conditional_t<IS_ADDRESS, const void*, std::string_view>>;
+
+        static void Encode(std::string& data, const T& value)
+        {
+            if constexpr (IS_TRIVIAL) {
+                data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            } else if constexpr (IS_ADDRESS) {
+                uintptr_t address = reinterpret_cast<uintptr_t>(value);
+                data.append(reinterpret_cast<const char*>(&address), sizeof(address));
+            } else if constexpr (std::is_pointer_v<T>) {
+                EncodeString(data, value != nullptr ? std::string_view(value) : std::string_view());
+            } else if constexpr (IS_STRING) {
+                EncodeString(data, std::string_view(value));
+            } else {
+                EncodeString(data, FORMAT("{}", value));
+            }
+        }
+
+        static Decoded Decode(const char*& data)
+        {
+            if constexpr (IS_TRIVIAL) {
+                T value;
+                std::memcpy(&value, data, sizeof(T));
+                data += sizeof(T);
+                return value;
+            } else if constexpr (IS_ADDRESS) {
+                uintptr_t address = 0;
+                std::memcpy(&address, data, sizeof(address));
+                data += sizeof(address);
+                return reinterpret_cast<const void*>(address);
+            } else {
+                size_t len = 0;
+                std::memcpy(&len, data, sizeof(len));
+                data += sizeof(len);
+                std::string_view value(data, len);
+                data += len;
+                return value;
+            }
+        }
+
+        static void EncodeString(std::string& data, std::string_view value)
+        {
+            size_t len = value.size();
+            data.append(reinterpret_cast<const char*>(&len), sizeof(len));
+            data.append(value.data(), len);
+        }
+    };
+
+    // Args are decayed types.
+    template <typename... Args>
+    struct ArgsCodec
+    {
+        static void Encode(std::string& data, const Args&... args)
+        {
+            (ArgCodec<Args>::Encode(data, args), ...);
+        }
+
+        // data is not read if there is no argument.
+        static void Format(std::string_view fmt, [[maybe_unused]] const char* data, std::string& out)
+        {
+            // the elements of braced initializer list are evaluated in order.
+            std::tuple<typename ArgCodec<Args>::Decoded...> values{ ArgCodec<Args>::Decode(data)... };
+            std::apply([&out, fmt](auto&... value) { FormatTo(out, fmt, value...); }, values);
+        }
+    };
+}
+
+#endif // !ARGS_CODEC_H
@@ -0,0 +1,47 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONSOLE_WRITER_H
+#define CONSOLE_WRITER_H
+
+#include <span>
+#include <string>
+#include <string_view>
+#include "Logger.h"
+
+namespace simple_logger
+{
+    // writer of the standard output, a batch of logs is written by one system call without the stream library,
+    // the logs are colored by the levels in their metadata. it is used by one thread.
+    class ConsoleWriter
+    {
+    public:
+        ConsoleWriter();
+
+        ConsoleWriter(const ConsoleWriter&) = delete;
+        ConsoleWriter& operator=(const ConsoleWriter&) = delete;
+
+    public:
+        // the colors are written only if the standard output is a terminal, they are not wanted in the pipes and files.
+        bool IsTerminal() const;
+        // metadata[i] describes logs[i], the logs are colored by their levels if colorful is true.
+        void Write(std::span<const std::string_view> logs, std::span<const LogMetadata> metadata, bool colorful);
+
+    private:
+        bool m_isTerminal = false;
+        std::string m_buffer;
+    };
+}
+
+#endif // !CONSOLE_WRITER_H
@@ -16,6 +16,7 @@
 #define DATA_TIME_H
 
 #include <string>
+#include <string_view>
 #include <chrono>
 
 namespace simple_logger 
@@ -55,6 +56,32 @@ namespace simple_logger
     std::string ToLocalTime(const time_t* time);
 
     time_t GetTimeFromString(std::string dateTime, std::string fmt = "%04d%02d%02d-%02d:%02d:%02d");
+
+    // local date time text with millisecond, like "2023-03-23 10:20:30.456".
+    // the text is rendered once per second, only the millisecond digits are updated for the time in the same second.
+    class DateTimeCache
+    {
+    public:
+        void Update(const Now& now);
+
+        std::string_view Text() const
+        {
+            return std::string_view(m_text, TEXT_SIZE);
+        }
+
+        // the date as an integer, like 20230323.
+        int Day() const
+        {
+            return m_day;
+        }
+
+    private:
+        static constexpr size_t TEXT_SIZE = 23;
+
+        time_t m_second = -1;
+        int m_day = 0;
+        char m_text[TEXT_SIZE + 1] = { 0 };
+    };
 }
 
 #endif // !DATA_TIME_H
\ No newline at end of file
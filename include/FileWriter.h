@@ -0,0 +1,68 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <string>
+#include <string_view>
+
+namespace simple_logger
+{
+    class IoUringWriter;
+
+    // appending file writer on a raw file descriptor with a user space buffer, the buffer is written to the file
+    // when it reaches the buffer size or Flush is called, so when the logs reach the disk is decided by the caller
+    // instead of the stream library. it is used by one thread.
+    class FileWriter
+    {
+    public:
+        FileWriter() = default;
+        ~FileWriter();
+
+        FileWriter(const FileWriter&) = delete;
+        FileWriter& operator=(const FileWriter&) = delete;
+
+    public:
+        // the file is written by ioUring asynchronously if it is not null.
+        bool Open(const std::string& filePath, IoUringWriter* ioUring = nullptr);
+        bool IsOpen() const;
+        // the buffer is written when it reaches bufferSize, 0 means it is written only by Flush.
+        void SetBufferSize(size_t bufferSize);
+        void Append(std::string_view data);
+        // write the buffer to the file.
+        void Flush();
+        // flush and wait until the file data reaches the disk.
+        void Sync();
+        void Close();
+        void Swap(FileWriter& other);
+
+        // the file size including the buffered data.
+        size_t Size() const;
+        bool HasBufferedData() const;
+
+    private:
+        // read the file size from the file system.
+        void SyncSize();
+
+    private:
+        int m_fd = -1;
+        IoUringWriter* m_ioUring = nullptr;
+        size_t m_size = 0;          // the bytes written to the file, it is also the offset of the next io_uring write.
+        size_t m_bufferSize = 0;
+        std::string m_buffer;
+    };
+}
+
+#endif // !FILE_WRITER_H
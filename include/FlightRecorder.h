@@ -0,0 +1,84 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace simple_logger
+{
+    // the header at the beginning of the flight recorder file.
+    struct FlightRecorderHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t capacity;      // the bytes of the data area after the header.
+        uint64_t writePos;      // the offset in the data area where the next record is written.
+        uint64_t sequence;      // the sequence number of the next record.
+        uint64_t wrapped;       // 1 if the data area has been written around.
+        uint64_t reserved[2];
+    };
+
+    // the header of each record in the data area, the payload follows it and the record is padded to 8 bytes.
+    struct FlightRecordHeader
+    {
+        uint32_t magic;
+        uint32_t length;        // the bytes of the payload.
+        uint64_t sequence;
+    };
+
+    // a fixed size memory mapped file used as a circular buffer of logs, the latest logs overwrite the oldest ones.
+    // writing a log is a memcpy into the mapping without system call, and the logs are still kept by the kernel
+    // if the process crashes. it is used by one writer thread.
+    class FlightRecorder
+    {
+    public:
+        FlightRecorder() = default;
+        ~FlightRecorder();
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    public:
+        // the file is created and pre-allocated with capacity bytes of data area, an existing file with the same
+        // capacity is continued. return false if the file can not be mapped.
+        bool Open(const std::string& filePath, size_t capacity);
+        bool IsOpen() const;
+        void Write(std::string_view msg);
+        void Close();
+
+        // read the records in the file from the oldest to the latest, return false if it is not a flight recorder file.
+        static bool ReadRecords(const std::string& filePath, std::vector<std::string>& records);
+
+    private:
+        char* m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+        FlightRecorderHeader* m_header = nullptr;
+        char* m_data = nullptr;
+        size_t m_capacity = 0;
+#ifdef _MSC_VER
+        void* m_file = nullptr;
+        void* m_fileMapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+}
+
+#endif // !FLIGHT_RECORDER_H
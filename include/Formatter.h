@@ -24,8 +24,13 @@
 #define HAS_STD_FORMAT
 #define FORMAT std::format
 #else
-#include <string>
+#include <array>
+#include <cstdint>
+#include <span>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 #define FORMAT simple_logger::format
 #endif
@@ -47,37 +52,350 @@ namespace simple_logger
         }
     };
 #else
-    void FormatExpand(std::stringstream& s, const char* fmt);
+    // the formatter used when <format> is missing, it supports "{}" and "{:[fill]align][0][width][.precision][type]}"
+    // like std::format, the align is one of '<', '>' and '^', the types are:
+    // integers: d, x, X, o, b, B. floating points: f, F, e, E, g, G. strings and bool: s. char: c. pointers: p.
+    // the other types are formatted by operator<<, and the enums are formatted as integers.
+    // the arguments are passed by reference and appended to the output directly, the numbers are converted by std::to_chars.
+    struct FormatSpec
+    {
+        char fill = ' ';
+        char align = '\0';     // '\0' means the default, numbers are aligned to right, the others are aligned to left.
+        bool zeroPad = false;
+        int width = 0;
+        int precision = -1;
+        char type = '\0';
+    };
+
+    // the type erased argument, it refers to the argument which should live until it is formatted.
+    struct FormatArg
+    {
+        enum class Type : uint8_t
+        {
+            Bool,
+            Char,
+            Int,
+            UInt,
+            Float,
+            Double,
+            LongDouble,
+            String,
+            Pointer,
+            Custom,     // formatted by operator<<.
+        };
+
+        Type type = Type::Custom;
+        union
+        {
+            bool boolValue;
+            char charValue;
+            int64_t intValue;
+            uint64_t uintValue;
+            float floatValue;
+            double doubleValue;
+            long double longDoubleValue;
+            struct
+            {
+                const char* data;
+                size_t size;
+            } stringValue;
+            const void* pointerValue;
+            struct
+            {
+                const void* value;
+                void (*append)(std::string& out, const void* value);
+            } customValue;
+        };
+    };
+
+    // T is the type of the argument with references and qualifiers.
+    template <typename T>
+    constexpr FormatArg::Type GetFormatArgType()
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            return FormatArg::Type::Bool;
+        } else if constexpr (std::is_same_v<U, char>) {
+            return FormatArg::Type::Char;
+        } else if constexpr (std::is_enum_v<U>) {
+            return FormatArg::Type::Int;
+        } else if constexpr (std::is_integral_v<U>) {
+            return std::is_signed_v<U> ? FormatArg::Type::Int : FormatArg::Type::UInt;
+        } else if constexpr (std::is_same_v<U, float>) {
+            return FormatArg::Type::Float;
+        } else if constexpr (std::is_same_v<U, double>) {
+            return FormatArg::Type::Double;
+        } else if constexpr (std::is_same_v<U, long double>) {
+            return FormatArg::Type::LongDouble;
+        } else if constexpr (std::is_null_pointer_v<U>) {
+            return FormatArg::Type::Pointer;
+        } else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+            return FormatArg::Type::String;
+        } else if constexpr (std::is_pointer_v<U>) {
+            return FormatArg::Type::Pointer;
+        } else {
+            return FormatArg::Type::Custom;
+        }
+    }
 
-    template<typename T, typename = typename std::enable_if<std::is_enum<T>::value>::type>
-    inline std::stringstream& operator<<(std::stringstream& ss, T& value)
+    template <typename T>
+    void AppendStreamed(std::string& out, const void* value)
     {
-        ss << static_cast<int>(value);
-        return ss;
+        std::ostringstream ss;
+        ss << *static_cast<const T*>(value);
+        out.append(ss.str());
     }
 
-    template<typename T, typename... Args>
-    void FormatExpand(std::stringstream& ss, const char* fmt, T& value, Args... args)
+    template <typename T>
+    FormatArg MakeFormatArg(const T& value)
     {
-        while (*fmt) {
-            if (*fmt == '{' && *(++fmt) == '}') {
-                ss << value;
-                FormatExpand(ss, ++fmt, args...);
-                return;
+        using U = std::remove_cvref_t<T>;
+        FormatArg arg;
+        arg.type = GetFormatArgType<T>();
+        if constexpr (std::is_same_v<U, bool>) {
+            arg.boolValue = value;
+        } else if constexpr (std::is_same_v<U, char>) {
+            arg.charValue = value;
+        } else if constexpr (std::is_enum_v<U>) {
+            arg.intValue = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<U>) {
+            if constexpr (std::is_signed_v<U>) {
+                arg.intValue = value;
+            } else {
+                arg.uintValue = value;
             }
-            ss << *fmt++;
+        } else if constexpr (std::is_same_v<U, float>) {
+            arg.floatValue = value;
+        } else if constexpr (std::is_same_v<U, double>) {
+            arg.doubleValue = value;
+        } else if constexpr (std::is_same_v<U, long double>) {
+            arg.longDoubleValue = value;
+        } else if constexpr (std::is_null_pointer_v<U>) {
+            arg.pointerValue = nullptr;
+        } else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+            std::string_view text;
+            if constexpr (std::is_pointer_v<U>) {
+                text = value != nullptr ? std::string_view(value) : std::string_view();
+            } else {
+                text = value;
+            }
+
+            arg.stringValue = { text.data(), text.size() };
+        } else if constexpr (std::is_pointer_v<U>) {
+            arg.pointerValue = static_cast<const void*>(value);
+        } else {
+            arg.customValue = { &value, &AppendStreamed<U> };
         }
-#ifndef NDEBUG
-        throw std::logic_error("Invalid formatting: too much arguments are provided to format");
-#endif
+
+        return arg;
+    }
+
+    // parse the spec after ':' in the placeholder, return false if it is invalid.
+    constexpr bool ParseFormatSpec(std::string_view spec, FormatSpec& result)
+    {
+        auto isAlign = [](char c) { return c == '<' || c == '>' || c == '^'; };
+        auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+        size_t i = 0;
+        if (spec.size() > 1 && isAlign(spec[1]) && spec[0] != '{' && spec[0] != '}') {
+            result.fill = spec[0];
+            result.align = spec[1];
+            i = 2;
+        } else if (!spec.empty() && isAlign(spec[0])) {
+            result.align = spec[0];
+            i = 1;
+        }
+
+        if (i < spec.size() && spec[i] == '0') {
+            result.zeroPad = true;
+            ++i;
+        }
+
+        for (; i < spec.size() && isDigit(spec[i]); ++i) {
+            result.width = result.width * 10 + (spec[i] - '0');
+            if (result.width > 4096) {
+                return false;
+            }
+        }
+
+        if (i < spec.size() && spec[i] == '.') {
+            if (++i == spec.size() || !isDigit(spec[i])) {
+                return false;
+            }
+
+            result.precision = 0;
+            for (; i < spec.size() && isDigit(spec[i]); ++i) {
+                result.precision = result.precision * 10 + (spec[i] - '0');
+                if (result.precision > 4096) {
+                    return false;
+                }
+            }
+        }
+
+        if (i < spec.size()) {
+            result.type = spec[i++];
+        }
+
+        return i == spec.size();
+    }
+
+    // whether the argument is formatted as a number, the numbers are aligned to right and can be padded with zeros.
+    constexpr bool IsNumberField(FormatArg::Type type, const FormatSpec& spec)
+    {
+        switch (type) {
+            case FormatArg::Type::Bool:
+                return spec.type != '\0' && spec.type != 's';
+            case FormatArg::Type::Char:
+                return spec.type != '\0' && spec.type != 'c';
+            case FormatArg::Type::String:
+            case FormatArg::Type::Pointer:
+            case FormatArg::Type::Custom:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // whether the spec can be used to format the type of argument.
+    constexpr bool IsFormatSpecValid(FormatArg::Type type, const FormatSpec& spec)
+    {
+        std::string_view types;
+        bool hasPrecision = false;
+        switch (type) {
+            case FormatArg::Type::Bool:
+                types = "sdxXobB";
+                break;
+            case FormatArg::Type::Char:
+                types = "cdxXobB";
+                break;
+            case FormatArg::Type::Int:
+            case FormatArg::Type::UInt:
+                types = "dxXobB";
+                break;
+            case FormatArg::Type::Float:
+            case FormatArg::Type::Double:
+            case FormatArg::Type::LongDouble:
+                types = "fFeEgG";
+                hasPrecision = true;
+                break;
+            case FormatArg::Type::String:
+                types = "s";
+                hasPrecision = true;
+                break;
+            case FormatArg::Type::Pointer:
+                types = "p";
+                break;
+            case FormatArg::Type::Custom:
+                break;
+        }
+
+        return (spec.type == '\0' || types.find(spec.type) != std::string_view::npos)
+            && (spec.precision < 0 || hasPrecision) && (!spec.zeroPad || IsNumberField(type, spec));
+    }
+
+    // check the format string with the types of arguments, return the error or null if it is valid.
+    constexpr const char* CheckFormatString(std::string_view fmt, std::span<const FormatArg::Type> types)
+    {
+        size_t argIndex = 0;
+        for (size_t i = 0; i < fmt.size(); ++i) {
+            if (fmt[i] == '}') {
+                if (i + 1 == fmt.size() || fmt[++i] != '}') {
+                    return "unmatched '}' in format string";
+                }
+                continue;
+            }
+
+            if (fmt[i] != '{') {
+                continue;
+            }
+
+            if (i + 1 < fmt.size() && fmt[i + 1] == '{') {
+                ++i;
+                continue;
+            }
+
+            size_t end = fmt.find('}', i);
+            if (end == std::string_view::npos) {
+                return "unmatched '{' in format string";
+            }
+
+            std::string_view spec = fmt.substr(i + 1, end - i - 1);
+            FormatSpec parsed;
+            if (!spec.empty() && (spec[0] != ':' || !ParseFormatSpec(spec.substr(1), parsed))) {
+                return "invalid format spec";
+            }
+
+            if (argIndex == types.size()) {
+                return "missing arguments";
+            }
+
+            if (!IsFormatSpecValid(types[argIndex++], parsed)) {
+                return "invalid format spec for the type of argument";
+            }
+
+            i = end;
+        }
+
+        return argIndex == types.size() ? nullptr : "too many arguments are provided to format";
+    }
+
+    // not constexpr, it makes the constant evaluation fail with the invalid format strings.
+    void InvalidFormatString(const char* error);
+
+    // the format string of Args, it is checked at compile time, like std::format_string.
+    template <typename... Args>
+    class FormatString
+    {
+    public:
+        template <typename T> requires std::is_convertible_v<const T&, std::string_view>
+        consteval FormatString(const T& fmt) : m_fmt(fmt)
+        {
+            constexpr std::array<FormatArg::Type, sizeof...(Args)> types{ GetFormatArgType<Args>()... };
+            const char* error = CheckFormatString(m_fmt, types);
+            if (error != nullptr) {
+                InvalidFormatString(error);
+            }
+        }
+
+        constexpr std::string_view Get() const
+        {
+            return m_fmt;
+        }
+
+    private:
+        std::string_view m_fmt;
+    };
+
+    // format the checked fmt with args and append the result to out.
+    void FormatArgs(std::string& out, std::string_view fmt, std::span<const FormatArg> args);
+
+    template <typename... Args>
+    void AppendFormat(std::string& out, FormatString<std::type_identity_t<Args>...> fmt, Args&&... args)
+    {
+        const std::array<FormatArg, sizeof...(Args)> formatArgs{ MakeFormatArg(args)... };
+        FormatArgs(out, fmt.Get(), formatArgs);
+    }
+
+    // the same as AppendFormat, but fmt is checked at runtime, std::runtime_error is thrown if it is invalid.
+    template <typename... Args>
+    void AppendVFormat(std::string& out, std::string_view fmt, Args&&... args)
+    {
+        constexpr std::array<FormatArg::Type, sizeof...(Args)> types{ GetFormatArgType<Args>()... };
+        const char* error = CheckFormatString(fmt, types);
+        if (error != nullptr) {
+            throw std::runtime_error(std::string("Invalid formatting: ") + error);
+        }
+
+        const std::array<FormatArg, sizeof...(Args)> formatArgs{ MakeFormatArg(args)... };
+        FormatArgs(out, fmt, formatArgs);
     }
 
-    template<typename ... Args>
-    std::string format(const char* fmt, Args ... args)
+    template <typename... Args>
+    std::string format(FormatString<std::type_identity_t<Args>...> fmt, Args&&... args)
     {
-        std::stringstream ss;
-        FormatExpand(ss, fmt, args...);
-        return ss.str();
+        std::string out;
+        const std::array<FormatArg, sizeof...(Args)> formatArgs{ MakeFormatArg(args)... };
+        FormatArgs(out, fmt.Get(), formatArgs);
+        return out;
     }
 #endif
 }
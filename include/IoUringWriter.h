@@ -0,0 +1,90 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IO_URING_WRITER_H
+#define IO_URING_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simple_logger
+{
+    constexpr unsigned DEFAULT_IO_URING_DEPTH = 8;
+
+    // asynchronous file writer based on linux io_uring, the writes are submitted with explicit offsets and several
+    // of them are in flight, so the writer thread does not wait for the disk unless all of them are in flight.
+    // it is built with the cmake option SIMPLE_LOGGER_IO_URING, otherwise Init always fails, and it is used by
+    // one thread.
+    class IoUringWriter
+    {
+    public:
+        IoUringWriter() = default;
+        ~IoUringWriter();
+
+        IoUringWriter(const IoUringWriter&) = delete;
+        IoUringWriter& operator=(const IoUringWriter&) = delete;
+
+    public:
+        // return false if io_uring is not built in or not available on the running kernel.
+        bool Init(unsigned depth = DEFAULT_IO_URING_DEPTH);
+        bool IsInit() const;
+        // write data to fd at offset, data is swapped with an idle buffer instead of being copied,
+        // so it is left with unspecified content.
+        void Write(int fd, std::string& data, uint64_t offset);
+        // wait until all the writes are completed, return false if io_uring fails to wait for them.
+        bool Drain();
+        // return true if any write completed short since the last call, the bytes it missed are not in the file.
+        bool TakeWriteFailure();
+        void Close();
+
+    private:
+        struct Request
+        {
+            std::string data;
+            int fd = -1;
+            uint64_t offset = 0;
+            bool inFlight = false;
+        };
+
+        bool Submit(Request& request, unsigned index);
+        // reap the completed writes, wait for one at least if wait is true.
+        // return false if the waiting failed, the writes may be still in flight.
+        bool Reap(bool wait);
+        void Complete(Request& request, int result);
+
+    private:
+        int m_ringFd = -1;
+        std::vector<Request> m_requests;
+        size_t m_inFlight = 0;
+        bool m_writeFailed = false;
+
+        void* m_sqRing = nullptr;
+        size_t m_sqRingSize = 0;
+        void* m_cqRing = nullptr;
+        size_t m_cqRingSize = 0;
+        void* m_sqes = nullptr;
+        size_t m_sqesSize = 0;
+
+        unsigned* m_sqTail = nullptr;
+        unsigned* m_sqMask = nullptr;
+        unsigned* m_sqArray = nullptr;
+        unsigned* m_cqHead = nullptr;
+        unsigned* m_cqTail = nullptr;
+        unsigned* m_cqMask = nullptr;
+        void* m_cqes = nullptr;
+    };
+}
+
+#endif // !IO_URING_WRITER_H
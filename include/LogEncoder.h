@@ -0,0 +1,40 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_ENCODER_H
+#define LOG_ENCODER_H
+
+#include <string>
+#include <string_view>
+#include "LogRecord.h"
+
+namespace simple_logger
+{
+    // append the text as the content of a JSON string, the quotation marks, the backslashes and the control
+    // characters are escaped, and the invalid UTF-8 bytes are replaced by U+FFFD, so the output is always valid.
+    // the text is scanned by SSE2 or AVX2 if they are available, only the bytes needing care go to the slow path.
+    void AppendJsonEscaped(std::string& out, std::string_view text);
+    // the same as AppendJsonEscaped, but scans byte by byte.
+    void AppendJsonEscapedScalar(std::string& out, std::string_view text);
+
+    // append the record as a line of JSON, like
+    // {"time":"2023-03-23T10:20:30.456","level":"Info","module":"net","file":"main.cpp","line":10,"func":"main","thread":123,"msg":"hello"}
+    // dateTime is the text like "2023-03-23 10:20:30.456" of the record.
+    void EncodeJson(const LogRecord& record, std::string_view dateTime, std::string& out);
+    // append the record as a line of logfmt, like
+    // time=2023-03-23T10:20:30.456 level=Info module="net" file="main.cpp" line=10 func="main" thread=123 msg="hello"
+    void EncodeLogfmt(const LogRecord& record, std::string_view dateTime, std::string& out);
+}
+
+#endif // !LOG_ENCODER_H
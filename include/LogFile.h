@@ -0,0 +1,102 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_FILE_H
+#define LOG_FILE_H
+
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include "FileWriter.h"
+#include "IoUringWriter.h"
+
+namespace simple_logger
+{
+    // the log file of a date, it is split into segments by size, like "2023-03-23_app.log", "2023-03-23_app.log.1",
+    // "2023-03-23_app.log.2", and the old segments of all dates are deleted by the retention limits.
+    // it is used by the file sink thread only, except the setters of the limits.
+    // if it is built with SIMPLE_LOGGER_IO_URING and io_uring is available, the segments are written asynchronously
+    // by io_uring, otherwise they are written by the write system call.
+    class LogFile
+    {
+    public:
+        LogFile(const std::string& dir, const std::string& name);
+        ~LogFile();
+
+        LogFile(const LogFile&) = delete;
+        LogFile& operator=(const LogFile&) = delete;
+
+    public:
+        // open the last segment of the date, it is created if it does not exist.
+        void Open(const std::string& date);
+        // the batch is buffered by the buffer policy, or written to the file at once if flushNow is true,
+        // a log is never split into two segments.
+        void Write(std::span<const std::string_view> batch, bool flushNow);
+        // write the buffered logs to the file.
+        void Flush();
+        // flush or sync the file if their intervals are due, it is called by the writer thread periodically.
+        void FlushIfDue();
+        // how long the writer thread can sleep before FlushIfDue should be called.
+        std::chrono::milliseconds GetFlushWaitTime() const;
+        void Close();
+
+        // the logs are buffered up to bufferSize bytes, and the buffer is written to the file when it is full or
+        // flushInterval passes, bufferSize 0 means each batch is written at once.
+        void SetBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval);
+        // the written logs are synchronized to the disk by fdatasync every syncInterval, 0 means never.
+        void SetSyncInterval(std::chrono::milliseconds syncInterval);
+
+        // the segment is switched to the next one before it exceeds maxFileSize, 0 means no limit.
+        void SetMaxFileSize(size_t maxFileSize);
+        // limit the count and the total bytes of the log files in the log directory, 0 means no limit.
+        void SetRetention(size_t maxFileCount, size_t maxTotalBytes);
+
+    private:
+        std::string GetSegmentPath(size_t index) const;
+        // return the segment index of the file of this log, or -1 if the file belongs to others.
+        long long GetSegmentIndex(const std::string& fileName, const std::string& date) const;
+        void OpenNextFile();
+        void CloseNextFile();
+        void Rotate();
+        void ApplyRetention();
+        void OpenSegment(const std::string& filePath, FileWriter& file);
+
+    private:
+        std::string m_dir;
+        std::string m_name;
+        std::string m_date;
+        size_t m_index = 0;
+        IoUringWriter m_ioUring;
+        FileWriter m_file;
+
+        // the next segment is opened in advance, the rotation only swaps the writers.
+        FileWriter m_nextFile;
+        std::string m_nextFilePath;
+
+        std::chrono::steady_clock::time_point m_lastFlush;
+        std::chrono::steady_clock::time_point m_lastSync;
+        bool m_unsynced = false;
+        std::atomic<size_t> m_bufferSize = 0;
+        std::atomic<int64_t> m_flushInterval = 0;   // in milliseconds.
+        std::atomic<int64_t> m_syncInterval = 0;    // in milliseconds.
+
+        std::atomic<size_t> m_maxFileSize = 0;
+        std::atomic<size_t> m_maxFileCount = 0;
+        std::atomic<size_t> m_maxTotalBytes = 0;
+    };
+}
+
+#endif // !LOG_FILE_H
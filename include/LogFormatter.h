@@ -0,0 +1,122 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_FORMATTER_H
+#define LOG_FORMATTER_H
+
+#include <charconv>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DateTime.h"
+#include "LogRecord.h"
+
+namespace simple_logger
+{
+    // the text of a batch of records formatted by a sink, the logs are the views of one buffer.
+    struct TextBatch
+    {
+        std::string buffer;
+        std::vector<std::string_view> logs;
+        std::vector<LogMetadata> metadata;
+        std::vector<size_t> ends;   // the end offset of each log in the buffer.
+    };
+
+    const char* LogLevelToStr(LogLevel level);
+    // the file name without the directory.
+    std::string_view GetFileName(std::string_view filePath);
+
+    template <typename T>
+    void AppendInteger(std::string& out, T value)
+    {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    // the layout of the logs compiled from a pattern like "%Y-%m-%d %H:%M:%S.%e [%l] [%n] %v", the pattern is parsed
+    // once into a list of fields, and the fields are appended one by one for every log. the flags:
+    // %Y year, %m month, %d day, %H hour, %M minute, %S second, %e millisecond, %l level, %L the first letter of level,
+    // %n module name, %N module id, %v message, %s file name, %g file path, %# line, %! function name,
+    // %t thread id, %w thread name, %% percent sign. the unknown flags are kept as they are.
+    // it is immutable after compiled, so it can be shared by threads.
+    class LogPattern
+    {
+    public:
+        explicit LogPattern(std::string_view pattern);
+
+    public:
+        // append the text of the record to out, dateTime is the text like "2023-03-23 10:20:30.456" of the record.
+        void Format(const LogRecord& record, std::string_view dateTime, std::string& out) const;
+        const std::string& GetPattern() const;
+
+    private:
+        enum class Field : uint8_t
+        {
+            Literal,
+            DateTime,   // a part of the date time text.
+            Level,
+            LevelLetter,
+            ModuleName,
+            ModuleId,
+            Message,
+            FileName,
+            FilePath,
+            Line,
+            FuncName,
+            ThreadId,
+            ThreadName,
+        };
+
+        struct Op
+        {
+            Field field;
+            uint32_t offset;    // the offset in m_literals or in the date time text.
+            uint32_t size;
+        };
+
+        void AddLiteral(std::string_view text);
+        void AddDateTime(uint32_t offset, uint32_t size);
+
+    private:
+        std::string m_pattern;
+        std::string m_literals;
+        std::vector<Op> m_ops;
+    };
+
+    // how a sink renders the records, the pattern and the detail mode work for LogEncoding::Text only.
+    struct FormatOptions
+    {
+        const LogPattern* pattern = nullptr;    // replaces the default layout if it is not null.
+        bool detailMode = true;
+        LogEncoding encoding = LogEncoding::Text;
+    };
+
+    // renders the records to text lines, like "2023-03-23 10:20:30.456 [Info] [module]: message" by default,
+    // or to JSON lines or logfmt lines by the encoding.
+    // each sink has its own formatter, it caches the date time text of the records, so it is used by one thread.
+    class LogFormatter
+    {
+    public:
+        // append the text of the record to out.
+        void Format(const LogRecord& record, const FormatOptions& options, std::string& out);
+        void Format(std::span<const LogRecord> records, const FormatOptions& options, TextBatch& batch);
+
+    private:
+        DateTimeCache m_dateTime;
+    };
+}
+
+#endif // !LOG_FORMATTER_H
@@ -0,0 +1,447 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_QUEUE_H
+#define LOG_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace simple_logger
+{
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // the queue between the writing threads and the log writer thread.
+    template <typename T>
+    class LogQueue
+    {
+    public:
+        virtual ~LogQueue() = default;
+
+    public:
+        // return false if the queue is full, the item is not moved in this case.
+        virtual bool Push(T&& item) = 0;
+        // return false if the queue is empty.
+        virtual bool Pop(T& item) = 0;
+        virtual bool Empty() const = 0;
+
+        // append at most maxCount items to the end of items, return the count of the popped items.
+        virtual size_t PopBatch(std::vector<T>& items, size_t maxCount)
+        {
+            size_t count = 0;
+            T item;
+            while (count < maxCount && Pop(item)) {
+                items.emplace_back(std::move(item));
+                ++count;
+            }
+
+            return count;
+        }
+    };
+
+    // unbounded queue guarded by a mutex.
+    template <typename T>
+    class LockedQueue : public LogQueue<T>
+    {
+    public:
+        virtual bool Push(T&& item) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_que.emplace_back(std::move(item));
+            return true;
+        }
+
+        virtual bool Pop(T& item) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_que.empty()) {
+                return false;
+            }
+
+            item = std::move(m_que.front());
+            m_que.pop_front();
+            return true;
+        }
+
+        // take the items in one lock.
+        virtual size_t PopBatch(std::vector<T>& items, size_t maxCount) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t count = std::min(maxCount, m_que.size());
+            std::move(m_que.begin(), m_que.begin() + count, std::back_inserter(items));
+            m_que.erase(m_que.begin(), m_que.begin() + count);
+            return count;
+        }
+
+        virtual bool Empty() const override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_que.empty();
+        }
+
+    private:
+        std::deque<T> m_que;
+        mutable std::mutex m_mutex;
+    };
+
+    // bounded lock-free multiple producers multiple consumers queue.
+    // each slot has a sequence number, a producer owns a slot when its sequence equals the enqueue position,
+    // a consumer owns it when its sequence equals the dequeue position + 1, so no lock is shared by both sides.
+    template <typename T>
+    class RingQueue : public LogQueue<T>
+    {
+    public:
+        // the capacity is rounded up to power of two.
+        explicit RingQueue(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+
+            m_mask = size - 1;
+            m_slots = std::make_unique<Slot[]>(size);
+            for (size_t i = 0; i < size; ++i) {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        RingQueue(const RingQueue&) = delete;
+        RingQueue& operator=(const RingQueue&) = delete;
+
+    public:
+        virtual bool Push(T&& item) override
+        {
+            Slot* slot = nullptr;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                slot = &m_slots[pos & m_mask];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            slot->data = std::move(item);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        virtual bool Pop(T& item) override
+        {
+            Slot* slot = nullptr;
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            while (true) {
+                slot = &m_slots[pos & m_mask];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            item = std::move(slot->data);
+            slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        virtual bool Empty() const override
+        {
+            return m_dequeuePos.load(std::memory_order_acquire) == m_enqueuePos.load(std::memory_order_acquire);
+        }
+
+        size_t Capacity() const
+        {
+            return m_mask + 1;
+        }
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        size_t m_mask = 0;
+        std::unique_ptr<Slot[]> m_slots;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePos = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePos = 0;
+    };
+
+    // bounded single producer single consumer queue, the producer and the consumer only share the two cursors.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        // the capacity is rounded up to power of two.
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+
+            m_mask = size - 1;
+            m_slots = std::make_unique<T[]>(size);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+    public:
+        // called by the producer only, return false if the queue is full, the arguments are not used in this case.
+        template <typename... Args>
+        bool Emplace(Args&&... args)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_headCache > m_mask) {
+                m_headCache = m_head.load(std::memory_order_acquire);
+                if (tail - m_headCache > m_mask) {
+                    return false;
+                }
+            }
+
+            m_slots[tail & m_mask] = T{ std::forward<Args>(args)... };
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // called by the consumer only, return nullptr if the queue is empty.
+        T* Front()
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tailCache) {
+                m_tailCache = m_tail.load(std::memory_order_acquire);
+                if (head == m_tailCache) {
+                    return nullptr;
+                }
+            }
+
+            return &m_slots[head & m_mask];
+        }
+
+        // called by the consumer only, after Front returns a valid item.
+        void PopFront()
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            m_slots[head & m_mask] = T();
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        bool Empty() const
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        size_t m_mask = 0;
+        std::unique_ptr<T[]> m_slots;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail = 0;
+        size_t m_headCache = 0;     // producer side copy of m_head.
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head = 0;
+        size_t m_tailCache = 0;     // consumer side copy of m_tail.
+    };
+
+    // each writing thread pushes to its own single producer single consumer buffer, so the threads share nothing on
+    // the enqueue path. The buffer is registered to the queue at the first push of the thread, and it is marked closed
+    // when the thread exits, the consumer drops it after the remaining items are popped.
+    // Only one thread may pop from this queue.
+    template <typename T>
+    class ThreadLocalQueue : public LogQueue<T>
+    {
+    public:
+        // if timestampMerge is true, the items of all threads are popped in the order of their pushing time,
+        // otherwise the threads are popped in round robin.
+        ThreadLocalQueue(size_t capacity, bool timestampMerge) : m_capacity(capacity), m_timestampMerge(timestampMerge)
+        {
+            static std::atomic<uint64_t> nextId = 1;
+            m_id = nextId.fetch_add(1);
+        }
+
+        virtual ~ThreadLocalQueue()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& buffer : m_buffers) {
+                buffer->detached.store(true, std::memory_order_release);
+            }
+        }
+
+        ThreadLocalQueue(const ThreadLocalQueue&) = delete;
+        ThreadLocalQueue& operator=(const ThreadLocalQueue&) = delete;
+
+    public:
+        virtual bool Push(T&& item) override
+        {
+            uint64_t ticks = m_timestampMerge ? std::chrono::steady_clock::now().time_since_epoch().count() : 0;
+            return GetThreadBuffer()->que.Emplace(ticks, std::move(item));
+        }
+
+        virtual bool Pop(T& item) override
+        {
+            RefreshBuffers();
+
+            Buffer* selected = nullptr;
+            Entry* selectedEntry = nullptr;
+            size_t count = m_consumerBuffers.size();
+            for (size_t i = 0; i < count; ++i) {
+                Buffer* buffer = m_consumerBuffers[(m_next + i) % count].get();
+                Entry* entry = buffer->que.Front();
+                if (entry == nullptr) {
+                    continue;
+                }
+
+                if (selectedEntry == nullptr || entry->ticks < selectedEntry->ticks) {
+                    selected = buffer;
+                    selectedEntry = entry;
+                }
+
+                if (!m_timestampMerge) {
+                    m_next = (m_next + i + 1) % count;
+                    break;
+                }
+            }
+
+            if (selected == nullptr) {
+                return false;
+            }
+
+            item = std::move(selectedEntry->item);
+            selected->que.PopFront();
+            return true;
+        }
+
+        virtual bool Empty() const override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& buffer : m_buffers) {
+                if (!buffer->que.Empty()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    private:
+        struct Entry
+        {
+            uint64_t ticks = 0;
+            T item;
+        };
+
+        struct Buffer
+        {
+            Buffer(size_t capacity, uint64_t owner) : que(capacity), owner(owner) {}
+
+            SpscQueue<Entry> que;
+            uint64_t owner;
+            std::atomic<bool> closed = false;     // the writing thread has exited.
+            std::atomic<bool> detached = false;   // the queue has been destroyed.
+        };
+
+        struct ThreadBuffers
+        {
+            ~ThreadBuffers()
+            {
+                for (auto& buffer : list) {
+                    buffer->closed.store(true, std::memory_order_release);
+                }
+            }
+
+            std::vector<std::shared_ptr<Buffer>> list;
+        };
+
+        Buffer* GetThreadBuffer()
+        {
+            thread_local ThreadBuffers buffers;
+            for (auto& buffer : buffers.list) {
+                if (buffer->owner == m_id) {
+                    return buffer.get();
+                }
+            }
+
+            std::erase_if(buffers.list, [](const std::shared_ptr<Buffer>& buffer) { return buffer->detached.load(std::memory_order_acquire); });
+
+            auto buffer = std::make_shared<Buffer>(m_capacity, m_id);
+            buffers.list.push_back(buffer);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffers.push_back(buffer);
+            m_version.fetch_add(1, std::memory_order_release);
+            return buffer.get();
+        }
+
+        // called by the consumer, pick up the new buffers and drop the drained buffers of the exited threads.
+        void RefreshBuffers()
+        {
+            bool hasClosed = false;
+            for (auto& buffer : m_consumerBuffers) {
+                // closed must be checked before empty, the thread pushes nothing after closing its buffer.
+                if (buffer->closed.load(std::memory_order_acquire) && buffer->que.Empty()) {
+                    hasClosed = true;
+                    break;
+                }
+            }
+
+            if (!hasClosed && m_version.load(std::memory_order_acquire) == m_consumerVersion) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::erase_if(m_buffers, [](const std::shared_ptr<Buffer>& buffer) {
+                return buffer->closed.load(std::memory_order_acquire) && buffer->que.Empty();
+            });
+            m_consumerBuffers = m_buffers;
+            m_consumerVersion = m_version.load(std::memory_order_relaxed);
+            m_next = 0;
+        }
+
+    private:
+        uint64_t m_id = 0;
+        size_t m_capacity = 0;
+        bool m_timestampMerge = false;
+
+        mutable std::mutex m_mutex;     // only taken when a thread registers its buffer, never on the pushing path.
+        std::vector<std::shared_ptr<Buffer>> m_buffers;
+        std::atomic<uint64_t> m_version = 0;
+
+        // used by the consumer only.
+        std::vector<std::shared_ptr<Buffer>> m_consumerBuffers;
+        uint64_t m_consumerVersion = 0;
+        size_t m_next = 0;
+    };
+}
+
+#endif // !LOG_QUEUE_H
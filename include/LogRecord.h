@@ -0,0 +1,49 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <string>
+#include <string_view>
+#include "ArgsCodec.h"
+#include "DateTime.h"
+#include "Logger.h"
+
+namespace simple_logger
+{
+    // the log passed from the log writing threads to the sinks, the fields are kept apart until a sink formats
+    // them, so each sink renders only what it needs in its own layout.
+    struct LogRecord
+    {
+        Now time;                   // the milliseconds since the epoch.
+        LogLevel level = LogLevel::Info;
+        bool newline = true;        // false for WriteMode::Append.
+        int module = 0;
+        std::string_view moduleName;    // filled by the log writer thread, the module names are never freed.
+        // the source location, they are static strings like __FILE__ and __FUNCTION__, or interned by the log.
+        const char* fileName = "";
+        int line = 0;
+        const char* funcName = "";
+        uint64_t threadId = 0;
+        const char* threadName = nullptr;
+        // the message, or the encoded arguments if formatFunc is not null, they are formatted by the log writer thread.
+        std::string message;
+        FormatFunc formatFunc = nullptr;
+        std::string_view fmt;
+        bool counted = false;       // counted in the queue limit.
+    };
+}
+
+#endif // !LOG_RECORD_H
@@ -15,22 +15,90 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include "ArgsCodec.h"
 #include "Formatter.h"
 
+// compile time log level, the print micros below SIMPLE_LOGGER_ACTIVE_LEVEL are stripped to empty statements,
+// their arguments are not evaluated and nothing of them is left in the binary.
+// it is set by the cmake option SIMPLE_LOGGER_ACTIVE_LEVEL, or defined before including this file.
+#define SIMPLE_LOGGER_LEVEL_DEBUG 1
+#define SIMPLE_LOGGER_LEVEL_INFO 2
+#define SIMPLE_LOGGER_LEVEL_WARN 4
+#define SIMPLE_LOGGER_LEVEL_ERROR 8
+#define SIMPLE_LOGGER_LEVEL_FATAL 16
+#define SIMPLE_LOGGER_LEVEL_OFF 32
+
+#ifndef SIMPLE_LOGGER_ACTIVE_LEVEL
+#define SIMPLE_LOGGER_ACTIVE_LEVEL SIMPLE_LOGGER_LEVEL_DEBUG
+#endif
+
+// an unknown level like SIMPLE_LOGGER_LEVEL_TRACE is 0 in #if, it would keep all the levels silently.
+#if SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_DEBUG && SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_INFO \
+    && SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_WARN && SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_ERROR \
+    && SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_FATAL && SIMPLE_LOGGER_ACTIVE_LEVEL != SIMPLE_LOGGER_LEVEL_OFF
+#error "SIMPLE_LOGGER_ACTIVE_LEVEL must be one of SIMPLE_LOGGER_LEVEL_DEBUG, INFO, WARN, ERROR, FATAL and OFF"
+#endif
+
 // used with module level print micro to simplify coding, for example:
-// #define EXAMPLE_DEBUG(fmt, ...) DBG_DEBUG(ExampleContext::GetInstance().GetLogger(), ExampleContext::GetInstance().GetModuleValue(), FORMAT(fmt, ##__VA_ARGS__))
+// #define EXAMPLE_DEBUG(fmt, ...) DBG_DEBUG(ExampleContext::GetInstance().GetLogger(), ExampleContext::GetInstance().GetModuleValue(), fmt, ##__VA_ARGS__)
 // EXAMPLE_DEBUG("This is a print example. str={}", "test");
 // see ../example/Example.cpp for more detail.
-#define DBG_DEBUG(log, mod, fmt, ...) log.Write(simple_logger::LogLevel::Debug, mod, __FILE__, __LINE__, __FUNCTION__, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__))
-#define DBG_INFO(log, mod, fmt, ...) log.Write(simple_logger::LogLevel::Info, mod, __FILE__, __LINE__, __FUNCTION__, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__))
-#define DBG_WARN(log, mod, fmt, ...) log.Write(simple_logger::LogLevel::Warn, mod, __FILE__, __LINE__, __FUNCTION__, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__))
-#define DBG_ERROR(log, mod, fmt, ...) log.Write(simple_logger::LogLevel::Error, mod, __FILE__, __LINE__, __FUNCTION__, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__))
-#define DBG_FATAL(log, mod, fmt, ...) log.Write(simple_logger::LogLevel::Fatal, mod, __FILE__, __LINE__, __FUNCTION__, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__))
+#if SIMPLE_LOGGER_ACTIVE_LEVEL <= SIMPLE_LOGGER_LEVEL_DEBUG
+#define DBG_DEBUG(log, mod, fmt, ...) DBG_WRITE(log, simple_logger::LogLevel::Debug, mod, fmt, ##__VA_ARGS__)
+#else
+#define DBG_DEBUG(log, mod, fmt, ...) do {} while (0)
+#endif
+
+#if SIMPLE_LOGGER_ACTIVE_LEVEL <= SIMPLE_LOGGER_LEVEL_INFO
+#define DBG_INFO(log, mod, fmt, ...) DBG_WRITE(log, simple_logger::LogLevel::Info, mod, fmt, ##__VA_ARGS__)
+#else
+#define DBG_INFO(log, mod, fmt, ...) do {} while (0)
+#endif
+
+#if SIMPLE_LOGGER_ACTIVE_LEVEL <= SIMPLE_LOGGER_LEVEL_WARN
+#define DBG_WARN(log, mod, fmt, ...) DBG_WRITE(log, simple_logger::LogLevel::Warn, mod, fmt, ##__VA_ARGS__)
+#else
+#define DBG_WARN(log, mod, fmt, ...) do {} while (0)
+#endif
+
+#if SIMPLE_LOGGER_ACTIVE_LEVEL <= SIMPLE_LOGGER_LEVEL_ERROR
+#define DBG_ERROR(log, mod, fmt, ...) DBG_WRITE(log, simple_logger::LogLevel::Error, mod, fmt, ##__VA_ARGS__)
+#else
+#define DBG_ERROR(log, mod, fmt, ...) do {} while (0)
+#endif
+
+#if SIMPLE_LOGGER_ACTIVE_LEVEL <= SIMPLE_LOGGER_LEVEL_FATAL
+#define DBG_FATAL(log, mod, fmt, ...) DBG_WRITE(log, simple_logger::LogLevel::Fatal, mod, fmt, ##__VA_ARGS__)
+#else
+#define DBG_FATAL(log, mod, fmt, ...) do {} while (0)
+#endif
+
+// the arguments are formatted only when the log will be written actually,
+// a disabled log(by level, output type or module filter) costs only a few flag checking.
+// in deferred format mode, the arguments are copied and formatted on the log writer thread.
+#define DBG_WRITE(log, level, mod, fmt, ...) \
+    do { \
+        simple_logger::Log& _log = (log); \
+        int _mod = (mod); \
+        if (_log.NeedWrite(level, _mod)) { \
+            static const simple_logger::LogSource _source{ __FILE__, __LINE__, __FUNCTION__, fmt }; \
+            if (_log.IsDeferredFormat()) { \
+                simple_logger::WriteDeferred(_log, level, _mod, _source, ##__VA_ARGS__); \
+            } else { \
+                _log.Write(level, _mod, _source, std::this_thread::get_id(), FORMAT(fmt, ##__VA_ARGS__)); \
+            } \
+        } \
+    } while (0)
 
 // micro definition for time performent evaluation 
 #define START_TIME() simple_logger::Now _begin = simple_logger::GetCurrentTime();
@@ -57,6 +125,7 @@ namespace simple_logger
         LogFile = 2,
         RemoteServer = 4,
         UserDefined = 8,
+        FlightRecorder = 16,    // the memory mapped circular file set by Log::SetFlightRecorder.
     };
 
     enum class WriteMode
@@ -65,26 +134,134 @@ namespace simple_logger
         Newline,
     };
 
+    enum class QueueType
+    {
+        Locked = 0,     // unbounded queue guarded by a mutex.
+        LockFree,       // bounded lock-free ring buffer, the producers wait when it is full.
+        ThreadLocal,    // bounded buffer per writing thread, drained in round robin, the capacity is per thread.
+        ThreadLocalOrdered, // bounded buffer per writing thread, drained in the order of writing time across threads.
+    };
+
+    // what to do when the log queue is full.
+    enum class OverflowPolicy
+    {
+        Block = 0,          // the log writing thread waits until the queue has room.
+        DropNewest,         // the new log is dropped.
+        DropOldest,         // the oldest log in the queue is dropped, it works as DropNewest for the thread local queues.
+        DropBelowLevel,     // the new log is dropped if its level is below the drop level, otherwise it works as Block.
+    };
+
+    // how the logs of a sink are encoded.
+    enum class LogEncoding
+    {
+        Text = 0,       // the default layout or the pattern set by Log::SetPattern.
+        JsonLines,      // one JSON object per line, like {"time":"2023-03-23T10:20:30.456","level":"Info",...,"msg":"hello"}.
+        Logfmt,         // one logfmt line per log, like time=2023-03-23T10:20:30.456 level=Info ... msg="hello".
+    };
+
+    // the module names and the module level flags in [0, MAX_MODULE_NUM) are looked up by dense tables,
+    // the names of the other modules are looked up by a hash map, and they always use the global level flag.
+    constexpr int MAX_MODULE_NUM = 256;
+    // the module level flag which means the module follows the global level flag.
+    constexpr uint32_t INHERITED_LEVEL_FLAG = 0xFFFFFFFF;
+
+    // the default capacity of QueueType::LockFree.
+    constexpr size_t DEFAULT_QUEUE_CAPACITY = 65536;
+    // the default capacity of the buffer of each thread of QueueType::ThreadLocal and QueueType::ThreadLocalOrdered,
+    // it is much smaller since every thread writing logs allocates its own buffer.
+    constexpr size_t DEFAULT_THREAD_QUEUE_CAPACITY = 1024;
+    constexpr size_t DEFAULT_MAX_BATCH_SIZE = 1024;
+
+    // the metadata of a log passed to the user defined writer with the formatted log.
+    struct LogMetadata
+    {
+        LogLevel level = LogLevel::Info;
+        int module = 0;
+        uint64_t threadId = 0;
+    };
+
     class UserDefinedWriter
     {
     public:
         virtual ~UserDefinedWriter() = default;
     public:
         virtual void Write(const std::string& str) = 0;
+        // the logs taken from the log queue at a time, metadata[i] describes logs[i], the views are valid until it returns.
+        // the logs are the views of one buffer rendered for the batch, override it to write the buffer at a time.
+        // the default copies the logs one by one into a string reused for the batch and passes it to Write.
+        virtual void WriteBatch(std::span<const std::string_view> logs, std::span<const LogMetadata> metadata)
+        {
+            (void)metadata;
+            std::string log;
+            for (std::string_view view : logs) {
+                log.assign(view);
+                Write(log);
+            }
+        }
         virtual void Close() {};
     };
 
+    // numeric id of the current thread, it is the kernel thread id on linux, and it is cached by the thread.
+    uint64_t GetCurrentThreadNumericId();
+    // name the current thread, the name is shown with the thread id in detail mode, like "thread: 12345/io-worker-3".
+    void SetCurrentThreadName(std::string_view name);
+
     template <class ...Args>
     uint32_t MakeFlag(Args... args)
     {
         return (... | static_cast<int>(args));
     }
 
+    // switches checked on the caller thread before formatting, see Log::NeedWrite.
+    struct LogSwitch
+    {
+        LogSwitch(uint32_t outputFlag, uint32_t logLevelFlag) : outputFlag(outputFlag), logLevelFlag(logLevelFlag)
+        {
+            for (auto& flag : moduleLevelFlag) {
+                flag.store(INHERITED_LEVEL_FLAG, std::memory_order_relaxed);
+            }
+        }
+
+        // the level flag of the module, or the global one if the module has no level flag of its own.
+        inline uint32_t GetLevelFlag(int module) const
+        {
+            if (module >= 0 && module < MAX_MODULE_NUM) {
+                uint32_t flag = moduleLevelFlag[module].load(std::memory_order_relaxed);
+                if (flag != INHERITED_LEVEL_FLAG) {
+                    return flag;
+                }
+            }
+
+            return logLevelFlag.load(std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32_t> outputFlag;
+        std::atomic<uint32_t> logLevelFlag;
+        std::array<std::atomic<uint32_t>, MAX_MODULE_NUM> moduleLevelFlag;
+        std::atomic<bool> moduleFilterOn = false;
+        std::atomic<bool> deferredFormat = false;
+    };
+
+    // static metadata of a print micro call site, fmt is any constant format string accepted by FORMAT,
+    // like a literal or a constexpr std::string_view.
+    struct LogSource
+    {
+        const char* fileName;
+        int line;
+        const char* funcName;
+        std::string_view fmt;
+    };
+
     class Log
     {
     public:
-        Log(const char* dir, const char* fileName, uint32_t outputFlag = MakeFlag(OutputType::LogFile), uint32_t logLevelFlag = MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal), bool detailMode = true);
-        Log(std::string_view dir, std::string_view fileName, uint32_t outputFlag = MakeFlag(OutputType::LogFile), uint32_t logLevelFlag = MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal), bool detailMode = true);
+        // queueCapacity is only used by the bounded queue types, it is rounded up to power of two, 0 means the default
+        // of the queue type. for the thread local queue types, it is the capacity of the buffer of each thread, so
+        // the memory is capacity * threads, DEFAULT_THREAD_QUEUE_CAPACITY is the default.
+        Log(const char* dir, const char* fileName, uint32_t outputFlag = MakeFlag(OutputType::LogFile), uint32_t logLevelFlag = MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal), bool detailMode = true,
+            QueueType queueType = QueueType::Locked, size_t queueCapacity = 0);
+        Log(std::string_view dir, std::string_view fileName, uint32_t outputFlag = MakeFlag(OutputType::LogFile), uint32_t logLevelFlag = MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal), bool detailMode = true,
+            QueueType queueType = QueueType::Locked, size_t queueCapacity = 0);
 
         Log(const Log& log) = delete;
         Log(const Log&& log) = delete;
@@ -102,10 +279,32 @@ namespace simple_logger
         bool IsLogSwitchOn(LogLevel level) const;
         void SetLogSwitchOn(LogLevel level);
         void SetLogSwitchOff(LogLevel level);
+        // the module level flag overrides the global level flag for the module in [0, MAX_MODULE_NUM), for example,
+        // SetModuleLevelFlag(NET, MakeFlag(LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal))
+        // writes the debug logs of NET only, while the other modules still follow the global level flag.
+        void SetModuleLevelFlag(int module, uint32_t logLevelFlag);
+        // the module follows the global level flag again.
+        void ClearModuleLevelFlag(int module);
+        void ClearAllModuleLevelFlag();
+        // the level flag in effect for the module.
+        uint32_t GetModuleLevelFlag(int module) const;
         void SetDetailMode(bool enable);
         bool IsDetailMode() const;
         void SetColorfulFont(bool enable);
         bool IsColorfulFont() const;
+        // the layout of the logs, like "%Y-%m-%d %H:%M:%S.%e [%l] [%n] [%s:%#] %v", it replaces the layout of the detail
+        // mode. the pattern is compiled once when it is set, an empty pattern restores the default layout. the flags:
+        // %Y year, %m month, %d day, %H hour, %M minute, %S second, %e millisecond, %l level, %L the first letter of level,
+        // %n module name, %N module id, %v message, %s file name, %g file path, %# line, %! function name,
+        // %t thread id, %w thread name, %% percent sign.
+        void SetPattern(const std::string& pattern);
+        // set the pattern of one output type.
+        void SetPattern(OutputType outputType, const std::string& pattern);
+        std::string GetPattern(OutputType outputType) const;
+        // encode the logs of the output type as JSON lines or logfmt for the log collectors, the strings are escaped
+        // and the invalid UTF-8 bytes are replaced, the console is not colorful when it is not LogEncoding::Text.
+        void SetEncoding(OutputType outputType, LogEncoding encoding);
+        LogEncoding GetEncoding(OutputType outputType) const;
         void SetReverseFilter(bool enable);
         bool IsReverseFilter() const;
 
@@ -137,16 +336,91 @@ namespace simple_logger
         void SetUserWriter(std::shared_ptr<UserDefinedWriter> m_userWriter);
         void SetRemoteWriter(std::shared_ptr<UserDefinedWriter> m_remoteWriter);
         bool IsLogQueEmpty() const;
-        
+        // the writer thread is waked up by the writing threads when new log comes, maxWaitTime is the upper bound of
+        // its sleeping in case of a missing notification, 0 means sleep until notified.
+        void SetMaxWaitTime(std::chrono::milliseconds maxWaitTime);
+        // the max count of logs taken from the queue and written to the output terminals at a time.
+        void SetMaxBatchSize(size_t maxBatchSize);
+        // limit the count and the total bytes of the logs in the queue, 0 means no limit.
+        void SetQueueLimit(size_t maxCount, size_t maxBytes);
+        void SetOverflowPolicy(OverflowPolicy policy, LogLevel dropLevel = LogLevel::Warn);
+        // the count of the logs dropped by the overflow policy.
+        uint64_t GetDroppedCount() const;
+        // each output terminal is written by its own thread, at most maxBatchCount batches wait for it, the policy
+        // decides what to do when they are full, so a slow output terminal can drop its own logs instead of holding
+        // the others. the default is 64 batches and OverflowPolicy::Block.
+        void SetSinkQueueLimit(OutputType outputType, size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel = LogLevel::Warn);
+        // the count of the logs dropped by the overflow policy of the output terminal.
+        uint64_t GetSinkDroppedCount(OutputType outputType) const;
+        // the log file is split into numbered segments like "<date>_<fileName>.1" before it exceeds maxFileSize,
+        // 0 means no limit.
+        void SetMaxFileSize(size_t maxFileSize);
+        // the oldest log files in the log directory are deleted when the count or the total bytes of the files
+        // exceed the limits, 0 means no limit.
+        void SetFileRetention(size_t maxFileCount, size_t maxTotalBytes);
+        // the logs are buffered up to bufferSize bytes before they are written to the log file, the buffer is also
+        // written when flushInterval passes, or at once when a log at flushLevel or above comes.
+        // bufferSize 0 means each batch of logs is written at once, which is the default.
+        void SetFileBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval, LogLevel flushLevel = LogLevel::Error);
+        // the log file is synchronized to the disk by fdatasync every syncInterval, 0 means never, which is the default.
+        void SetFileSyncInterval(std::chrono::milliseconds syncInterval);
+        // the flight recorder keeps the latest capacity bytes of logs in a memory mapped file, they are kept even if
+        // the process crashes, and they can be read by the flight_recorder_reader tool.
+        // it works when OutputType::FlightRecorder is on, return false if the file can not be mapped.
+        bool SetFlightRecorder(const std::string& filePath, size_t capacity);
+
+        // return false if the log will be dropped by level, output type or module filter,
+        // it is called before formatting to avoid the formatting cost of the disabled logs.
+        inline bool NeedWrite(LogLevel level, int module) const
+        {
+            if ((m_switch.GetLevelFlag(module) & static_cast<uint32_t>(level)) == 0
+                || m_switch.outputFlag.load(std::memory_order_relaxed) == 0) {
+                return false;
+            }
+
+            return !m_switch.moduleFilterOn.load(std::memory_order_relaxed) || !NeedFilter(module);
+        }
+
+        // fileName and funcName are interned by the log, so they can be temporary strings, the count of the distinct
+        // names should be small like the source locations, they are kept until the log is destroyed. the names passed
+        // again by a thread are found in its cache without locking, the names after the first 65536 ones are not kept.
         void Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, const std::string& msg, WriteMode writeMode = WriteMode::Newline);
+        // used by the print micros, the strings of source are kept until the log is written, so source must be static.
+        void Write(LogLevel level, int module, const LogSource& source, std::thread::id threadId, const std::string& msg, WriteMode writeMode = WriteMode::Newline);
+        // the temporary message like the one formatted by the print micros is moved into the log instead of being copied.
+        void Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, std::string&& msg, WriteMode writeMode = WriteMode::Newline);
+        void Write(LogLevel level, int module, const LogSource& source, std::thread::id threadId, std::string&& msg, WriteMode writeMode = WriteMode::Newline);
+
+        // in deferred format mode, the print micros only copy the arguments, both the message and the log header are
+        // formatted on the log writer thread, it moves the formatting cost away from the log writing threads.
+        void SetDeferredFormat(bool enable);
+        inline bool IsDeferredFormat() const
+        {
+            return m_switch.deferredFormat.load(std::memory_order_relaxed);
+        }
+
+        // args is encoded by ArgsCodec, and it is decoded and formatted by formatFunc on the log writer thread.
+        void WriteDeferred(LogLevel level, int module, const LogSource& source, std::thread::id threadId, FormatFunc formatFunc, std::string&& args);
 
         // Close function should be called munually before the program exit.
         void Close();
 
+    private:
+        bool NeedFilter(int module) const;
+
     private:
         class LogImpl;
+        LogSwitch m_switch;
         std::unique_ptr<LogImpl> m_impl;
     };
+
+    template <typename... Args>
+    void WriteDeferred(Log& log, LogLevel level, int module, const LogSource& source, const Args&... args)
+    {
+        std::string data;
+        ArgsCodec<std::decay_t<const Args&>...>::Encode(data, args...);
+        log.WriteDeferred(level, module, source, std::this_thread::get_id(), &ArgsCodec<std::decay_t<const Args&>...>::Format, std::move(data));
+    }
 };
 
 #endif // !LOGGER_H
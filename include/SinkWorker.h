@@ -0,0 +1,89 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SINK_WORKER_H
+#define SINK_WORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "LogRecord.h"
+#include "Logger.h"
+
+namespace simple_logger
+{
+    constexpr size_t DEFAULT_SINK_QUEUE_SIZE = 64;
+
+    // the records taken from the log queue at a time, it is shared by all the sinks without copying,
+    // each sink formats the records by itself.
+    struct SinkBatch
+    {
+        std::vector<LogRecord> records;
+        LogLevel maxLevel = LogLevel::Debug;
+    };
+
+    // the thread of an output terminal, the log writer thread hands the batches to the sink workers, so a slow
+    // output terminal only backs up its own queue, and its overflow policy decides whether it holds the log writer
+    // thread or drops its batches.
+    class SinkWorker
+    {
+    public:
+        using WriteFunc = std::function<void(const SinkBatch& batch)>;
+        // called when the worker is idle, return how long it can sleep before it should be called again.
+        using IdleFunc = std::function<std::chrono::milliseconds()>;
+
+        SinkWorker(WriteFunc writeFunc, IdleFunc idleFunc = nullptr);
+        ~SinkWorker();
+
+        SinkWorker(const SinkWorker&) = delete;
+        SinkWorker& operator=(const SinkWorker&) = delete;
+
+    public:
+        // limit the count of the batches waiting in the queue, OverflowPolicy::DropBelowLevel drops the batches
+        // without any log at dropLevel or above.
+        void SetQueueLimit(size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel);
+        // the thread is started by the first batch.
+        void Push(const std::shared_ptr<const SinkBatch>& batch);
+        // write the queued batches and stop the thread.
+        void Stop();
+        // the count of the logs dropped by the overflow policy.
+        uint64_t GetDroppedCount() const;
+
+    private:
+        void Run();
+
+    private:
+        WriteFunc m_writeFunc;
+        IdleFunc m_idleFunc;
+
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::deque<std::shared_ptr<const SinkBatch>> m_batches;
+        size_t m_maxBatchCount = DEFAULT_SINK_QUEUE_SIZE;
+        OverflowPolicy m_overflowPolicy = OverflowPolicy::Block;
+        LogLevel m_dropLevel = LogLevel::Warn;
+        std::atomic<uint64_t> m_droppedCount = 0;
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+}
+
+#endif // !SINK_WORKER_H
@@ -0,0 +1,157 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AhoCorasick.h"
+
+#include <queue>
+
+namespace simple_logger
+{
+    AhoCorasick::AhoCorasick(const std::unordered_set<std::string>& patterns)
+    {
+        m_patternCount = patterns.size();
+
+        for (const std::string& pattern : patterns) {
+            m_hasEmptyPattern = m_hasEmptyPattern || pattern.empty();
+            for (unsigned char c : pattern) {
+                if (m_byteClass[c] == 0) {
+                    m_byteClass[c] = static_cast<uint16_t>(m_classCount++);
+                }
+            }
+        }
+
+        // build the trie, -1 means no edge.
+        m_transitions.assign(m_classCount, -1);
+        m_patternIds.push_back(-1);
+        int32_t patternId = 0;
+        for (const std::string& pattern : patterns) {
+            int32_t state = 0;
+            for (unsigned char c : pattern) {
+                size_t index = static_cast<size_t>(state) * m_classCount + m_byteClass[c];
+                if (m_transitions[index] < 0) {
+                    m_transitions[index] = static_cast<int32_t>(m_patternIds.size());
+                    m_transitions.resize(m_transitions.size() + m_classCount, -1);
+                    m_patternIds.push_back(-1);
+                }
+
+                state = m_transitions[index];
+            }
+
+            if (!pattern.empty()) {
+                m_patternIds[state] = patternId;
+            }
+
+            ++patternId;
+        }
+
+        // turn the trie into a automaton in breadth first order, the missing edges follow the failure links.
+        std::vector<int32_t> failLinks(m_patternIds.size(), 0);
+        m_outputLinks.assign(m_patternIds.size(), -1);
+        std::queue<int32_t> states;
+        for (size_t c = 0; c < m_classCount; ++c) {
+            int32_t& next = m_transitions[c];
+            if (next < 0) {
+                next = 0;
+            } else {
+                states.push(next);
+            }
+        }
+
+        while (!states.empty()) {
+            int32_t state = states.front();
+            states.pop();
+
+            int32_t fail = failLinks[state];
+            m_outputLinks[state] = m_patternIds[fail] >= 0 ? fail : m_outputLinks[fail];
+
+            for (size_t c = 0; c < m_classCount; ++c) {
+                size_t index = static_cast<size_t>(state) * m_classCount + c;
+                int32_t failNext = m_transitions[static_cast<size_t>(fail) * m_classCount + c];
+                if (m_transitions[index] < 0) {
+                    m_transitions[index] = failNext;
+                } else {
+                    failLinks[m_transitions[index]] = failNext;
+                    states.push(m_transitions[index]);
+                }
+            }
+        }
+
+        for (int32_t& next : m_transitions) {
+            bool hasOutput = m_patternIds[next] >= 0 || m_outputLinks[next] >= 0;
+            next *= static_cast<int32_t>(m_classCount);
+            next = hasOutput ? ~next : next;
+        }
+    }
+
+    bool AhoCorasick::Empty() const
+    {
+        return m_patternCount == 0;
+    }
+
+    bool AhoCorasick::MatchAny(std::string_view text) const
+    {
+        if (m_patternCount == 0) {
+            return false;
+        }
+
+        if (m_hasEmptyPattern) {
+            return true;
+        }
+
+        int32_t row = 0;
+        for (unsigned char c : text) {
+            row = m_transitions[row + m_byteClass[c]];
+            if (row < 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool AhoCorasick::MatchAll(std::string_view text) const
+    {
+        size_t remaining = m_hasEmptyPattern ? m_patternCount - 1 : m_patternCount;
+        if (remaining == 0) {
+            return true;
+        }
+
+        thread_local std::vector<uint64_t> found;
+        found.assign((m_patternCount + 63) / 64, 0);
+
+        int32_t row = 0;
+        for (unsigned char c : text) {
+            row = m_transitions[row + m_byteClass[c]];
+            if (row >= 0) {
+                continue;
+            }
+
+            row = ~row;
+            int32_t state = row / static_cast<int32_t>(m_classCount);
+            int32_t output = m_patternIds[state] >= 0 ? state : m_outputLinks[state];
+            for (; output >= 0; output = m_outputLinks[output]) {
+                int32_t id = m_patternIds[output];
+                uint64_t bit = 1ULL << (id % 64);
+                if ((found[id / 64] & bit) == 0) {
+                    found[id / 64] |= bit;
+                    if (--remaining == 0) {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ConsoleWriter.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace simple_logger
+{
+    constexpr std::string_view FONT_STYLE_RED = "\033[31m";
+    constexpr std::string_view FONT_STYLE_GREEN = "\033[32m";
+    constexpr std::string_view FONT_STYLE_YELLOW = "\033[33m";
+    constexpr std::string_view FONT_STYLE_PURPLE = "\033[35m";
+    constexpr std::string_view FONT_STYLE_CYAN = "\033[36m";
+    constexpr std::string_view FONT_STYLE_CLEAR = "\033[0m";
+
+    static std::string_view GetFontColor(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Debug:
+                return FONT_STYLE_GREEN;
+            case LogLevel::Info:
+                return FONT_STYLE_CYAN;
+            case LogLevel::Warn:
+                return FONT_STYLE_YELLOW;
+            case LogLevel::Error:
+                return FONT_STYLE_RED;
+            case LogLevel::Fatal:
+                return FONT_STYLE_PURPLE;
+            default:
+                return FONT_STYLE_CLEAR;
+        }
+    }
+
+    ConsoleWriter::ConsoleWriter()
+    {
+#ifdef _MSC_VER
+        m_isTerminal = _isatty(_fileno(stdout)) != 0;
+#else
+        m_isTerminal = isatty(STDOUT_FILENO) != 0;
+#endif
+    }
+
+    bool ConsoleWriter::IsTerminal() const
+    {
+        return m_isTerminal;
+    }
+
+    void ConsoleWriter::Write(std::span<const std::string_view> logs, std::span<const LogMetadata> metadata, bool colorful)
+    {
+        colorful = colorful && m_isTerminal;
+        m_buffer.clear();
+        for (size_t i = 0; i < logs.size(); ++i) {
+            if (colorful) {
+                m_buffer.append(GetFontColor(i < metadata.size() ? metadata[i].level : LogLevel::Info)).append(logs[i]).append(FONT_STYLE_CLEAR);
+            } else {
+                m_buffer.append(logs[i]);
+            }
+        }
+
+        // the output of printf and std::cout is written before the logs.
+        std::fflush(stdout);
+#ifdef _MSC_VER
+        std::fwrite(m_buffer.data(), 1, m_buffer.size(), stdout);
+        std::fflush(stdout);
+#else
+        size_t written = 0;
+        while (written < m_buffer.size()) {
+            ssize_t ret = write(STDOUT_FILENO, m_buffer.data() + written, m_buffer.size() - written);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (ret <= 0) {
+                break;
+            }
+
+            written += static_cast<size_t>(ret);
+        }
+#endif
+    }
+}
@@ -340,4 +340,25 @@ namespace simple_logger
 
         return mktime(&t);
     }
+
+    void DateTimeCache::Update(const Now& now)
+    {
+        time_t t = std::chrono::system_clock::to_time_t(now);
+        if (t != m_second) {
+            tm localTm = { 0 };
+            if (GetLocalTime(&t, &localTm) != 0) {
+                return;
+            }
+
+            strftime(m_text, sizeof(m_text), "%Y-%m-%d %H:%M:%S", &localTm);
+            m_text[19] = '.';
+            m_day = (localTm.tm_year + 1900) * 10000 + (localTm.tm_mon + 1) * 100 + localTm.tm_mday;
+            m_second = t;
+        }
+
+        int milliSecond = static_cast<int>(now.time_since_epoch().count() % 1000);
+        m_text[20] = static_cast<char>('0' + milliSecond / 100);
+        m_text[21] = static_cast<char>('0' + milliSecond / 10 % 10);
+        m_text[22] = static_cast<char>('0' + milliSecond % 10);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FileWriter.h"
+
+#include <cerrno>
+#include <utility>
+
+#include "IoUringWriter.h"
+
+#ifdef _MSC_VER
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace simple_logger
+{
+    FileWriter::~FileWriter()
+    {
+        Close();
+    }
+
+    bool FileWriter::Open(const std::string& filePath, IoUringWriter* ioUring)
+    {
+        Close();
+
+        // the write system call appends by O_APPEND, io_uring writes at explicit offsets so it can not use O_APPEND.
+#ifdef _MSC_VER
+        int fd = -1;
+        _sopen_s(&fd, filePath.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | _O_NOINHERIT, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+        m_ioUring = nullptr;
+#else
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+        int fd = open(filePath.c_str(), ioUring != nullptr ? flags : flags | O_APPEND, 0644);
+        m_ioUring = ioUring;
+#endif
+        if (fd < 0) {
+            m_ioUring = nullptr;
+            return false;
+        }
+
+        m_fd = fd;
+        SyncSize();
+        return true;
+    }
+
+    bool FileWriter::IsOpen() const
+    {
+        return m_fd >= 0;
+    }
+
+    void FileWriter::SetBufferSize(size_t bufferSize)
+    {
+        m_bufferSize = bufferSize;
+        if (m_buffer.capacity() < bufferSize) {
+            m_buffer.reserve(bufferSize);
+        }
+    }
+
+    void FileWriter::Append(std::string_view data)
+    {
+        m_buffer.append(data);
+        if (m_bufferSize > 0 && m_buffer.size() >= m_bufferSize) {
+            Flush();
+        }
+    }
+
+    void FileWriter::Flush()
+    {
+        if (m_buffer.empty() || m_fd < 0) {
+            return;
+        }
+
+        if (m_ioUring != nullptr) {
+            size_t size = m_buffer.size();
+            m_ioUring->Write(m_fd, m_buffer, m_size);
+            m_size += size;
+            // a failed write leaves a hole at its offset, so the offset of the next write is taken from the file.
+            if (m_ioUring->TakeWriteFailure()) {
+                m_ioUring->Drain();
+                SyncSize();
+            }
+        } else {
+            // the bytes which can not be written are dropped, only the written ones are counted.
+            size_t written = 0;
+            while (written < m_buffer.size()) {
+#ifdef _MSC_VER
+                int ret = _write(m_fd, m_buffer.data() + written, static_cast<unsigned>(m_buffer.size() - written));
+#else
+                ssize_t ret = write(m_fd, m_buffer.data() + written, m_buffer.size() - written);
+#endif
+                if (ret < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (ret <= 0) {
+                    break;
+                }
+
+                written += static_cast<size_t>(ret);
+            }
+
+            m_size += written;
+        }
+
+        m_buffer.clear();
+    }
+
+    void FileWriter::Sync()
+    {
+        Flush();
+        if (m_fd < 0) {
+            return;
+        }
+
+        if (m_ioUring != nullptr) {
+            m_ioUring->Drain();
+            if (m_ioUring->TakeWriteFailure()) {
+                SyncSize();
+            }
+        }
+
+#ifdef _MSC_VER
+        _commit(m_fd);
+#elif defined(linux)
+        fdatasync(m_fd);
+#else
+        fsync(m_fd);
+#endif
+    }
+
+    void FileWriter::Close()
+    {
+        if (m_fd < 0) {
+            return;
+        }
+
+        Flush();
+        if (m_ioUring != nullptr) {
+            m_ioUring->Drain();
+        }
+
+#ifdef _MSC_VER
+        _close(m_fd);
+#else
+        close(m_fd);
+#endif
+        m_fd = -1;
+        m_size = 0;
+        m_ioUring = nullptr;
+    }
+
+    void FileWriter::Swap(FileWriter& other)
+    {
+        std::swap(m_fd, other.m_fd);
+        std::swap(m_ioUring, other.m_ioUring);
+        std::swap(m_size, other.m_size);
+        std::swap(m_bufferSize, other.m_bufferSize);
+        m_buffer.swap(other.m_buffer);
+    }
+
+    size_t FileWriter::Size() const
+    {
+        return m_size + m_buffer.size();
+    }
+
+    bool FileWriter::HasBufferedData() const
+    {
+        return !m_buffer.empty();
+    }
+
+    void FileWriter::SyncSize()
+    {
+#ifdef _MSC_VER
+        struct _stat64 status;
+        m_size = _fstat64(m_fd, &status) == 0 ? static_cast<size_t>(status.st_size) : 0;
+#else
+        struct stat status;
+        m_size = fstat(m_fd, &status) == 0 ? static_cast<size_t>(status.st_size) : 0;
+#endif
+    }
+}
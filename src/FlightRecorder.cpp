@@ -0,0 +1,290 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _MSC_VER
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace simple_logger
+{
+    constexpr char FLIGHT_RECORDER_MAGIC[8] = { 'S', 'L', 'F', 'L', 'I', 'G', 'H', 'T' };
+    constexpr uint32_t FLIGHT_RECORDER_VERSION = 1;
+    constexpr uint32_t RECORD_MAGIC = 0x4C524653;
+    constexpr uint32_t PADDING_MAGIC = 0x44415046;      // the rest of the data area is not used before it wraps.
+    constexpr size_t MIN_FLIGHT_RECORDER_CAPACITY = 4096;
+
+    static_assert(sizeof(FlightRecorderHeader) == 64, "the header size is part of the file format");
+    static_assert(sizeof(FlightRecordHeader) == 16, "the record header size is part of the file format");
+
+    static size_t AlignRecordSize(size_t size)
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    FlightRecorder::~FlightRecorder()
+    {
+        Close();
+    }
+
+    bool FlightRecorder::Open(const std::string& filePath, size_t capacity)
+    {
+        Close();
+
+        capacity = AlignRecordSize(std::max(capacity, MIN_FLIGHT_RECORDER_CAPACITY));
+        size_t fileSize = sizeof(FlightRecorderHeader) + capacity;
+
+#ifdef _MSC_VER
+        HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(fileSize);
+        HANDLE fileMapping = nullptr;
+        void* mapping = nullptr;
+        if (SetFilePointerEx(file, size, nullptr, FILE_BEGIN) && SetEndOfFile(file)) {
+            fileMapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        }
+
+        if (fileMapping != nullptr) {
+            mapping = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, fileSize);
+        }
+
+        if (mapping == nullptr) {
+            if (fileMapping != nullptr) {
+                CloseHandle(fileMapping);
+            }
+
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_fileMapping = fileMapping;
+#else
+        int fd = open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return false;
+        }
+
+        // allocate the blocks in advance, so writing the mapping never fails for lack of disk space.
+        struct stat fileStat;
+        bool sized = fstat(fd, &fileStat) == 0 && (static_cast<size_t>(fileStat.st_size) == fileSize || ftruncate(fd, static_cast<off_t>(fileSize)) == 0);
+#ifdef linux
+        sized = sized && posix_fallocate(fd, 0, static_cast<off_t>(fileSize)) == 0;
+#endif
+        void* mapping = sized ? mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+#endif
+
+        m_mapping = static_cast<char*>(mapping);
+        m_mappingSize = fileSize;
+        m_header = reinterpret_cast<FlightRecorderHeader*>(m_mapping);
+        m_data = m_mapping + sizeof(FlightRecorderHeader);
+        m_capacity = capacity;
+
+        // continue the records written before, unless the file is not a flight recorder file of the same capacity.
+        bool valid = std::memcmp(m_header->magic, FLIGHT_RECORDER_MAGIC, sizeof(FLIGHT_RECORDER_MAGIC)) == 0
+            && m_header->version == FLIGHT_RECORDER_VERSION && m_header->headerSize == sizeof(FlightRecorderHeader)
+            && m_header->capacity == capacity && m_header->writePos <= capacity && m_header->writePos % 8 == 0;
+        if (!valid) {
+            std::memset(m_header, 0, sizeof(FlightRecorderHeader));
+            m_header->version = FLIGHT_RECORDER_VERSION;
+            m_header->headerSize = sizeof(FlightRecorderHeader);
+            m_header->capacity = capacity;
+            std::memcpy(m_header->magic, FLIGHT_RECORDER_MAGIC, sizeof(FLIGHT_RECORDER_MAGIC));
+        }
+
+        return true;
+    }
+
+    bool FlightRecorder::IsOpen() const
+    {
+        return m_mapping != nullptr;
+    }
+
+    void FlightRecorder::Write(std::string_view msg)
+    {
+        if (m_mapping == nullptr) {
+            return;
+        }
+
+        // the too long log is truncated to fit in the data area.
+        size_t length = std::min(msg.size(), m_capacity - sizeof(FlightRecordHeader));
+        size_t recordSize = AlignRecordSize(sizeof(FlightRecordHeader) + length);
+        size_t pos = m_header->writePos;
+        uint64_t sequence = m_header->sequence;
+
+        if (pos + recordSize > m_capacity) {
+            if (m_capacity - pos >= sizeof(FlightRecordHeader)) {
+                FlightRecordHeader padding{ PADDING_MAGIC, 0, sequence };
+                std::memcpy(m_data + pos, &padding, sizeof(padding));
+            }
+
+            pos = 0;
+            m_header->wrapped = 1;
+        }
+
+        // invalidate the old record at pos first, a crash in the middle of the copying leaves no valid looking record.
+        FlightRecordHeader record{ 0, static_cast<uint32_t>(length), sequence };
+        std::memcpy(m_data + pos, &record, sizeof(record));
+        std::memcpy(m_data + pos + sizeof(record), msg.data(), length);
+        record.magic = RECORD_MAGIC;
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(m_data + pos, &record.magic, sizeof(record.magic));
+
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->writePos = pos + recordSize;
+        m_header->sequence = sequence + 1;
+    }
+
+    void FlightRecorder::Close()
+    {
+        if (m_mapping == nullptr) {
+            return;
+        }
+
+#ifdef _MSC_VER
+        FlushViewOfFile(m_mapping, m_mappingSize);
+        UnmapViewOfFile(m_mapping);
+        CloseHandle(m_fileMapping);
+        CloseHandle(m_file);
+        m_fileMapping = nullptr;
+        m_file = nullptr;
+#else
+        msync(m_mapping, m_mappingSize, MS_ASYNC);
+        munmap(m_mapping, m_mappingSize);
+        close(m_fd);
+        m_fd = -1;
+#endif
+
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+        m_header = nullptr;
+        m_data = nullptr;
+        m_capacity = 0;
+    }
+
+    bool FlightRecorder::ReadRecords(const std::string& filePath, std::vector<std::string>& records)
+    {
+        std::ifstream file(filePath, std::ios::in | std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        FlightRecorderHeader header;
+        if (content.size() < sizeof(header)) {
+            return false;
+        }
+
+        std::memcpy(&header, content.data(), sizeof(header));
+        if (std::memcmp(header.magic, FLIGHT_RECORDER_MAGIC, sizeof(FLIGHT_RECORDER_MAGIC)) != 0 || header.version != FLIGHT_RECORDER_VERSION
+            || header.headerSize != sizeof(header) || content.size() < header.headerSize + header.capacity || header.writePos > header.capacity) {
+            return false;
+        }
+
+        const char* data = content.data() + header.headerSize;
+        size_t capacity = header.capacity;
+
+        // return the size of the valid record at pos, 0 for the padding, or -1 if there is no valid record.
+        auto getRecord = [data, capacity](size_t pos, size_t end, FlightRecordHeader& record) -> long long {
+            if (pos + sizeof(record) > end) {
+                return -1;
+            }
+
+            std::memcpy(&record, data + pos, sizeof(record));
+            if (record.magic == PADDING_MAGIC) {
+                return 0;
+            }
+
+            size_t recordSize = AlignRecordSize(sizeof(record) + record.length);
+            if (record.magic != RECORD_MAGIC || record.length > capacity || pos + recordSize > end) {
+                return -1;
+            }
+
+            return static_cast<long long>(recordSize);
+        };
+
+        // read the records in [begin, end), return false if they are not continuous records until end.
+        // sequence is set to the sequence of the last record read.
+        auto readRange = [&getRecord, data, capacity](size_t begin, size_t end, std::vector<std::string>* result, uint64_t& sequence) -> bool {
+            FlightRecordHeader record;
+            size_t pos = begin;
+            while (pos + sizeof(record) <= end) {
+                long long recordSize = getRecord(pos, end, record);
+                if (recordSize == 0) {
+                    return end == capacity;
+                }
+
+                if (recordSize < 0 || (pos != begin && record.sequence != sequence + 1)) {
+                    return false;
+                }
+
+                if (result != nullptr) {
+                    result->emplace_back(data + pos + sizeof(record), record.length);
+                }
+
+                sequence = record.sequence;
+                pos += static_cast<size_t>(recordSize);
+            }
+
+            return true;
+        };
+
+        records.clear();
+        size_t writePos = header.writePos;
+        uint64_t sequence = 0;
+        if (header.wrapped != 0) {
+            // the records after writePos are older than the first record of the data area.
+            FlightRecordHeader first;
+            uint64_t firstSequence = getRecord(0, writePos, first) > 0 ? first.sequence : header.sequence;
+            // the oldest record is the first one after writePos that leads a continuous chain to the end, and the
+            // chain is followed by the first record. the beginning of the old records may have been overwritten
+            // partially, and the records of the earlier rounds may be left after the padding of the last round.
+            for (size_t pos = writePos; pos + sizeof(FlightRecordHeader) <= capacity; pos += 8) {
+                FlightRecordHeader record;
+                if (getRecord(pos, capacity, record) > 0 && readRange(pos, capacity, nullptr, sequence) && sequence + 1 == firstSequence) {
+                    readRange(pos, capacity, &records, sequence);
+                    break;
+                }
+            }
+        }
+
+        readRange(0, writePos, &records, sequence);
+        return true;
+    }
+}
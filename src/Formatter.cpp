@@ -14,22 +14,205 @@
 
 #include "Formatter.h"
 
+#ifndef HAS_STD_FORMAT
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#endif
+
 namespace simple_logger
 {
 #ifndef HAS_STD_FORMAT
-    void FormatExpand(std::stringstream& ss, const char* fmt)
-    {
-        while (*fmt) {
-            if (*fmt == '{' && *(++fmt) == '}') {
-#ifndef NDEBUG
-                throw std::runtime_error("Invalid format string: missing arguments");
-#else
-                ++fmt;
-                ++fmt;
-#endif
+    void InvalidFormatString(const char* error)
+    {
+        throw std::runtime_error(std::string("Invalid formatting: ") + error);
+    }
+
+    static int GetIntegerBase(char type)
+    {
+        switch (type) {
+            case 'x':
+            case 'X':
+                return 16;
+            case 'o':
+                return 8;
+            case 'b':
+            case 'B':
+                return 2;
+            default:
+                return 10;
+        }
+    }
+
+    template <typename T>
+    static void AppendInteger(std::string& out, T value, char type)
+    {
+        char buffer[72];    // enough for 64 binary digits with the sign.
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, GetIntegerBase(type));
+        out.append(buffer, result.ptr);
+    }
+
+    template <typename T>
+    static void AppendFloat(std::string& out, T value, const FormatSpec& spec)
+    {
+        // convert into out directly, the fixed format of the large numbers may need hundreds of chars.
+        size_t offset = out.size();
+        size_t capacity = 64;
+        while (true) {
+            out.resize(offset + capacity);
+            char* first = out.data() + offset;
+            char* last = first + capacity;
+            std::to_chars_result result;
+            if (spec.type == '\0' && spec.precision < 0) {
+                result = std::to_chars(first, last, value);     // the shortest text that round trips.
+            } else {
+                std::chars_format format = std::chars_format::general;
+                switch (spec.type) {
+                    case 'f':
+                    case 'F':
+                        format = std::chars_format::fixed;
+                        break;
+                    case 'e':
+                    case 'E':
+                        format = std::chars_format::scientific;
+                        break;
+                    default:
+                        break;
+                }
+
+                result = std::to_chars(first, last, value, format, spec.precision < 0 ? 6 : spec.precision);
+            }
+
+            if (result.ec == std::errc()) {
+                out.resize(result.ptr - out.data());
+                return;
+            }
+
+            capacity *= 2;
+        }
+    }
+
+    static void AppendArg(std::string& out, const FormatArg& arg, const FormatSpec& spec)
+    {
+        switch (arg.type) {
+            case FormatArg::Type::Bool:
+                if (spec.type == '\0' || spec.type == 's') {
+                    out.append(arg.boolValue ? "true" : "false");
+                } else {
+                    AppendInteger(out, static_cast<int>(arg.boolValue), spec.type);
+                }
+                break;
+            case FormatArg::Type::Char:
+                if (spec.type == '\0' || spec.type == 'c') {
+                    out.push_back(arg.charValue);
+                } else {
+                    AppendInteger(out, static_cast<int>(arg.charValue), spec.type);
+                }
+                break;
+            case FormatArg::Type::Int:
+                AppendInteger(out, arg.intValue, spec.type);
+                break;
+            case FormatArg::Type::UInt:
+                AppendInteger(out, arg.uintValue, spec.type);
+                break;
+            case FormatArg::Type::Float:
+                AppendFloat(out, arg.floatValue, spec);
+                break;
+            case FormatArg::Type::Double:
+                AppendFloat(out, arg.doubleValue, spec);
+                break;
+            case FormatArg::Type::LongDouble:
+                AppendFloat(out, arg.longDoubleValue, spec);
+                break;
+            case FormatArg::Type::String: {
+                std::string_view text(arg.stringValue.data, arg.stringValue.size);
+                out.append(spec.precision < 0 ? text : text.substr(0, spec.precision));
+                break;
             }
-            ss << *fmt++;
+            case FormatArg::Type::Pointer:
+                out.append("0x");
+                AppendInteger(out, reinterpret_cast<uintptr_t>(arg.pointerValue), 'x');
+                break;
+            case FormatArg::Type::Custom:
+                arg.customValue.append(out, arg.customValue.value);
+                break;
         }
     }
+
+    static bool IsFinite(const FormatArg& arg)
+    {
+        switch (arg.type) {
+            case FormatArg::Type::Float:
+                return std::isfinite(arg.floatValue);
+            case FormatArg::Type::Double:
+                return std::isfinite(arg.doubleValue);
+            case FormatArg::Type::LongDouble:
+                return std::isfinite(arg.longDoubleValue);
+            default:
+                return true;
+        }
+    }
+
+    // format the argument into out, and pad the text from offset to the width.
+    static void AppendField(std::string& out, const FormatArg& arg, const FormatSpec& spec)
+    {
+        size_t offset = out.size();
+        AppendArg(out, arg, spec);
+        if (spec.type == 'X' || spec.type == 'E' || spec.type == 'F' || spec.type == 'G' || spec.type == 'B') {
+            std::transform(out.begin() + offset, out.end(), out.begin() + offset, [](char c) { return static_cast<char>(std::toupper(c)); });
+        }
+
+        size_t size = out.size() - offset;
+        size_t width = static_cast<size_t>(spec.width);
+        if (size >= width) {
+            return;
+        }
+
+        size_t padding = width - size;
+        // the zeros are put after the sign, inf and nan are padded with the fill like std::format.
+        if (spec.zeroPad && spec.align == '\0' && IsFinite(arg)) {
+            size_t position = offset + (out[offset] == '-' ? 1 : 0);
+            out.insert(position, padding, '0');
+            return;
+        }
+
+        char align = spec.align != '\0' ? spec.align : (IsNumberField(arg.type, spec) ? '>' : '<');
+        size_t before = align == '>' ? padding : (align == '^' ? padding / 2 : 0);
+        out.insert(offset, before, spec.fill);
+        out.append(padding - before, spec.fill);
+    }
+
+    void FormatArgs(std::string& out, std::string_view fmt, std::span<const FormatArg> args)
+    {
+        size_t argIndex = 0;
+        size_t begin = 0;
+        for (size_t i = 0; i < fmt.size(); ++i) {
+            char c = fmt[i];
+            if (c != '{' && c != '}') {
+                continue;
+            }
+
+            out.append(fmt.substr(begin, i - begin));
+            // "{{" and "}}" are escaped braces.
+            if (c == '}' || fmt[i + 1] == '{') {
+                out.push_back(c);
+                begin = ++i + 1;
+                continue;
+            }
+
+            size_t end = fmt.find('}', i);
+            FormatSpec spec;
+            if (end > i + 1) {
+                ParseFormatSpec(fmt.substr(i + 2, end - i - 2), spec);
+            }
+
+            AppendField(out, args[argIndex++], spec);
+            i = end;
+            begin = end + 1;
+        }
+
+        out.append(fmt.substr(begin));
+    }
 #endif
 }
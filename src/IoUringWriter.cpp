@@ -0,0 +1,317 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "IoUringWriter.h"
+
+#ifdef SIMPLE_LOGGER_IO_URING
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace simple_logger
+{
+#ifdef SIMPLE_LOGGER_IO_URING
+    // the system calls are used directly, so liburing is not needed.
+    static int IoUringSetup(unsigned entries, io_uring_params* params)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    static int IoUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    IoUringWriter::~IoUringWriter()
+    {
+        Close();
+    }
+
+    bool IoUringWriter::Init(unsigned depth)
+    {
+        Close();
+
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int ringFd = IoUringSetup(depth, &params);
+        if (ringFd < 0) {
+            return false;
+        }
+
+        m_ringFd = ringFd;
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+
+        m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (m_sqRing == MAP_FAILED) {
+            m_sqRing = nullptr;
+            Close();
+            return false;
+        }
+
+        if (singleMmap) {
+            m_cqRing = m_sqRing;
+        } else {
+            m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            if (m_cqRing == MAP_FAILED) {
+                m_cqRing = nullptr;
+                Close();
+                return false;
+            }
+        }
+
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (m_sqes == MAP_FAILED) {
+            m_sqes = nullptr;
+            Close();
+            return false;
+        }
+
+        char* sqRing = static_cast<char*>(m_sqRing);
+        m_sqTail = reinterpret_cast<unsigned*>(sqRing + params.sq_off.tail);
+        m_sqMask = reinterpret_cast<unsigned*>(sqRing + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sqRing + params.sq_off.array);
+        char* cqRing = static_cast<char*>(m_cqRing);
+        m_cqHead = reinterpret_cast<unsigned*>(cqRing + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cqRing + params.cq_off.tail);
+        m_cqMask = reinterpret_cast<unsigned*>(cqRing + params.cq_off.ring_mask);
+        m_cqes = cqRing + params.cq_off.cqes;
+
+        // no more requests than the submission entries, so the submission queue is never full.
+        m_requests = std::vector<Request>(params.sq_entries);
+        m_inFlight = 0;
+        return true;
+    }
+
+    bool IoUringWriter::IsInit() const
+    {
+        return m_ringFd >= 0;
+    }
+
+    void IoUringWriter::Write(int fd, std::string& data, uint64_t offset)
+    {
+        if (data.empty()) {
+            return;
+        }
+
+        if (m_inFlight == m_requests.size()) {
+            Reap(true);
+        }
+
+        unsigned index = 0;
+        while (index < m_requests.size() && m_requests[index].inFlight) {
+            ++index;
+        }
+
+        // write it synchronously if no request is completed.
+        Request idle;
+        Request& request = index < m_requests.size() ? m_requests[index] : idle;
+        request.data.swap(data);
+        request.fd = fd;
+        request.offset = offset;
+        if (&request == &idle || !Submit(request, index)) {
+            Complete(request, -EIO);
+        }
+
+        // collect the completed writes without waiting.
+        Reap(false);
+    }
+
+    bool IoUringWriter::Submit(Request& request, unsigned index)
+    {
+        unsigned tail = *m_sqTail;
+        unsigned slot = tail & *m_sqMask;
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(m_sqes) + slot;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = request.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(request.data.data());
+        sqe->len = static_cast<uint32_t>(request.data.size());
+        sqe->off = request.offset;
+        sqe->user_data = index;
+        m_sqArray[slot] = slot;
+
+        std::atomic_ref<unsigned>(*m_sqTail).store(tail + 1, std::memory_order_release);
+        request.inFlight = true;
+        ++m_inFlight;
+
+        int ret = 0;
+        do {
+            ret = IoUringEnter(m_ringFd, 1, 0, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0) {
+            // take the entry back, it is not consumed by the kernel.
+            std::atomic_ref<unsigned>(*m_sqTail).store(tail, std::memory_order_release);
+            request.inFlight = false;
+            --m_inFlight;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool IoUringWriter::Reap(bool wait)
+    {
+        while (m_inFlight > 0) {
+            unsigned head = *m_cqHead;
+            unsigned tail = std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire);
+            if (head == tail) {
+                if (!wait) {
+                    return true;
+                }
+
+                // the interrupted or temporarily busy waiting is retried, the writes are still owned by the kernel.
+                if (IoUringEnter(m_ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0
+                    && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            for (; head != tail; ++head) {
+                io_uring_cqe* cqe = static_cast<io_uring_cqe*>(m_cqes) + (head & *m_cqMask);
+                Request& request = m_requests[cqe->user_data];
+                request.inFlight = false;
+                --m_inFlight;
+                Complete(request, cqe->res);
+            }
+
+            std::atomic_ref<unsigned>(*m_cqHead).store(head, std::memory_order_release);
+            wait = false;
+        }
+
+        return true;
+    }
+
+    void IoUringWriter::Complete(Request& request, int result)
+    {
+        // the short or failed write is finished synchronously, the kernel may not support IORING_OP_WRITE.
+        size_t written = result > 0 ? static_cast<size_t>(result) : 0;
+        while (written < request.data.size()) {
+            ssize_t ret = pwrite(request.fd, request.data.data() + written, request.data.size() - written, static_cast<off_t>(request.offset + written));
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (ret <= 0) {
+                break;
+            }
+
+            written += static_cast<size_t>(ret);
+        }
+
+        m_writeFailed = m_writeFailed || written < request.data.size();
+        request.data.clear();
+    }
+
+    bool IoUringWriter::Drain()
+    {
+        while (m_inFlight > 0) {
+            if (!Reap(true)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool IoUringWriter::TakeWriteFailure()
+    {
+        return std::exchange(m_writeFailed, false);
+    }
+
+    void IoUringWriter::Close()
+    {
+        if (m_ringFd < 0) {
+            return;
+        }
+
+        if (!Drain()) {
+            // the kernel may still read the buffers of the writes in flight, so the rings and the buffers are leaked
+            // instead of being freed under it. moving the vector keeps the requests at their addresses.
+            new std::vector<Request>(std::move(m_requests));
+            m_ringFd = -1;
+            m_sqRing = m_cqRing = m_sqes = nullptr;
+            m_requests.clear();
+            m_inFlight = 0;
+            return;
+        }
+
+        if (m_sqes != nullptr) {
+            munmap(m_sqes, m_sqesSize);
+        }
+
+        if (m_cqRing != nullptr && m_cqRing != m_sqRing) {
+            munmap(m_cqRing, m_cqRingSize);
+        }
+
+        if (m_sqRing != nullptr) {
+            munmap(m_sqRing, m_sqRingSize);
+        }
+
+        close(m_ringFd);
+        m_ringFd = -1;
+        m_sqRing = m_cqRing = m_sqes = nullptr;
+        m_requests.clear();
+        m_inFlight = 0;
+    }
+#else
+    IoUringWriter::~IoUringWriter()
+    {
+    }
+
+    bool IoUringWriter::Init(unsigned)
+    {
+        return false;
+    }
+
+    bool IoUringWriter::IsInit() const
+    {
+        return false;
+    }
+
+    void IoUringWriter::Write(int, std::string&, uint64_t)
+    {
+    }
+
+    bool IoUringWriter::Drain()
+    {
+        return true;
+    }
+
+    bool IoUringWriter::TakeWriteFailure()
+    {
+        return false;
+    }
+
+    void IoUringWriter::Close()
+    {
+    }
+#endif
+}
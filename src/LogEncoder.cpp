@@ -0,0 +1,250 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "LogEncoder.h"
+
+#include <bit>
+#include <cstdint>
+
+#include "LogFormatter.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMPLE_LOGGER_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMPLE_LOGGER_SSE2
+#endif
+
+namespace simple_logger
+{
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    constexpr std::string_view REPLACEMENT_CHARACTER = "\xEF\xBF\xBD";  // U+FFFD in UTF-8.
+
+    // the bytes going to the slow path, the non-ASCII bytes are checked as UTF-8.
+    static bool NeedEscape(unsigned char c)
+    {
+        return c < 0x20 || c == '"' || c == '\\' || c >= 0x80;
+    }
+
+    // the length of the valid UTF-8 sequence at the beginning of text, 0 if it is invalid.
+    static size_t GetUtf8Length(const unsigned char* text, size_t size)
+    {
+        auto isContinuation = [text, size](size_t i) { return i < size && (text[i] & 0xC0) == 0x80; };
+        unsigned char c = text[0];
+        if (c >= 0xC2 && c <= 0xDF) {
+            return isContinuation(1) ? 2 : 0;
+        }
+
+        if (c >= 0xE0 && c <= 0xEF) {
+            // the overlong forms and the surrogates are invalid.
+            if (size < 3 || (c == 0xE0 && text[1] < 0xA0) || (c == 0xED && text[1] > 0x9F)) {
+                return 0;
+            }
+
+            return isContinuation(1) && isContinuation(2) ? 3 : 0;
+        }
+
+        if (c >= 0xF0 && c <= 0xF4) {
+            // the overlong forms and the code points above U+10FFFF are invalid.
+            if (size < 4 || (c == 0xF0 && text[1] < 0x90) || (c == 0xF4 && text[1] > 0x8F)) {
+                return 0;
+            }
+
+            return isContinuation(1) && isContinuation(2) && isContinuation(3) ? 4 : 0;
+        }
+
+        return 0;
+    }
+
+    // append the escaped text of the byte at text[i] which needs escaping, return the count of the bytes consumed.
+    static size_t AppendEscapedChar(std::string& out, std::string_view text, size_t i)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c) {
+            case '"':
+                out.append("\\\"");
+                return 1;
+            case '\\':
+                out.append("\\\\");
+                return 1;
+            case '\b':
+                out.append("\\b");
+                return 1;
+            case '\f':
+                out.append("\\f");
+                return 1;
+            case '\n':
+                out.append("\\n");
+                return 1;
+            case '\r':
+                out.append("\\r");
+                return 1;
+            case '\t':
+                out.append("\\t");
+                return 1;
+            default:
+                break;
+        }
+
+        if (c < 0x20) {
+            char escaped[] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF] };
+            out.append(escaped, sizeof(escaped));
+            return 1;
+        }
+
+        size_t length = GetUtf8Length(reinterpret_cast<const unsigned char*>(text.data()) + i, text.size() - i);
+        if (length == 0) {
+            out.append(REPLACEMENT_CHARACTER);
+            return 1;
+        }
+
+        out.append(text.substr(i, length));
+        return length;
+    }
+
+    // escape text from i, the bytes in [begin, i) are not appended yet.
+    static void AppendJsonEscapedFrom(std::string& out, std::string_view text, size_t i, size_t begin)
+    {
+        while (i < text.size()) {
+            if (!NeedEscape(static_cast<unsigned char>(text[i]))) {
+                ++i;
+                continue;
+            }
+
+            out.append(text.substr(begin, i - begin));
+            i += AppendEscapedChar(out, text, i);
+            begin = i;
+        }
+
+        out.append(text.substr(begin));
+    }
+
+    void AppendJsonEscapedScalar(std::string& out, std::string_view text)
+    {
+        AppendJsonEscapedFrom(out, text, 0, 0);
+    }
+
+    void AppendJsonEscaped(std::string& out, std::string_view text)
+    {
+        const char* data = text.data();
+        size_t size = text.size();
+        size_t i = 0;
+        size_t begin = 0;
+        // the bytes below 0x20 and the bytes from 0x80 are both less than 0x20 in the signed comparison.
+#ifdef SIMPLE_LOGGER_AVX2
+        const __m256i quote256 = _mm256_set1_epi8('"');
+        const __m256i backslash256 = _mm256_set1_epi8('\\');
+        const __m256i space256 = _mm256_set1_epi8(0x20);
+        while (i + 32 <= size) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i mask = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote256), _mm256_cmpeq_epi8(chunk, backslash256)),
+                _mm256_cmpgt_epi8(space256, chunk));
+            uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(mask));
+            if (bits == 0) {
+                i += 32;
+                continue;
+            }
+
+            i += std::countr_zero(bits);
+            out.append(data + begin, i - begin);
+            i += AppendEscapedChar(out, text, i);
+            begin = i;
+        }
+#endif
+#ifdef SIMPLE_LOGGER_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i space = _mm_set1_epi8(0x20);
+        while (i + 16 <= size) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i mask = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), _mm_cmplt_epi8(chunk, space));
+            uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(mask));
+            if (bits == 0) {
+                i += 16;
+                continue;
+            }
+
+            i += std::countr_zero(bits);
+            out.append(data + begin, i - begin);
+            i += AppendEscapedChar(out, text, i);
+            begin = i;
+        }
+#endif
+        AppendJsonEscapedFrom(out, text, i, begin);
+    }
+
+    // append the date time text in ISO 8601 form, like "2023-03-23T10:20:30.456".
+    static void AppendIsoDateTime(std::string& out, std::string_view dateTime)
+    {
+        size_t offset = out.size();
+        out.append(dateTime);
+        if (dateTime.size() > 10) {
+            out[offset + 10] = 'T';
+        }
+    }
+
+    void EncodeJson(const LogRecord& record, std::string_view dateTime, std::string& out)
+    {
+        out.append("{\"time\":\"");
+        AppendIsoDateTime(out, dateTime);
+        out.append("\",\"level\":\"").append(LogLevelToStr(record.level)).append("\",\"module\":\"");
+        AppendJsonEscaped(out, record.moduleName);
+        out.append("\",\"file\":\"");
+        AppendJsonEscaped(out, GetFileName(record.fileName));
+        out.append("\",\"line\":");
+        AppendInteger(out, record.line);
+        out.append(",\"func\":\"");
+        AppendJsonEscaped(out, record.funcName);
+        out.append("\",\"thread\":");
+        AppendInteger(out, record.threadId);
+        if (record.threadName != nullptr) {
+            out.append(",\"thread_name\":\"");
+            AppendJsonEscaped(out, record.threadName);
+            out.push_back('"');
+        }
+
+        out.append(",\"msg\":\"");
+        AppendJsonEscaped(out, record.message);
+        out.append("\"}\n");
+    }
+
+    void EncodeLogfmt(const LogRecord& record, std::string_view dateTime, std::string& out)
+    {
+        // the string values are always quoted, so they need no checking of the spaces and the equal signs.
+        out.append("time=");
+        AppendIsoDateTime(out, dateTime);
+        out.append(" level=").append(LogLevelToStr(record.level)).append(" module=\"");
+        AppendJsonEscaped(out, record.moduleName);
+        out.append("\" file=\"");
+        AppendJsonEscaped(out, GetFileName(record.fileName));
+        out.append("\" line=");
+        AppendInteger(out, record.line);
+        out.append(" func=\"");
+        AppendJsonEscaped(out, record.funcName);
+        out.append("\" thread=");
+        AppendInteger(out, record.threadId);
+        if (record.threadName != nullptr) {
+            out.append(" thread_name=\"");
+            AppendJsonEscaped(out, record.threadName);
+            out.push_back('"');
+        }
+
+        out.append(" msg=\"");
+        AppendJsonEscaped(out, record.message);
+        out.append("\"\n");
+    }
+}
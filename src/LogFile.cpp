@@ -0,0 +1,322 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "LogFile.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <tuple>
+#include <vector>
+
+namespace simple_logger
+{
+    LogFile::LogFile(const std::string& dir, const std::string& name) : m_dir(dir), m_name(name)
+    {
+        m_ioUring.Init();
+    }
+
+    LogFile::~LogFile()
+    {
+        Close();
+    }
+
+    void LogFile::Open(const std::string& date)
+    {
+        Close();
+        m_date = date;
+
+        // continue the last segment of the date, the log may be restarted in the same day.
+        m_index = 0;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(m_dir, ec)) {
+            long long index = GetSegmentIndex(entry.path().filename().string(), m_date);
+            if (index > 0 && static_cast<size_t>(index) > m_index) {
+                m_index = static_cast<size_t>(index);
+            }
+        }
+
+        OpenSegment(GetSegmentPath(m_index), m_file);
+        m_lastFlush = m_lastSync = std::chrono::steady_clock::now();
+
+        OpenNextFile();
+        ApplyRetention();
+    }
+
+    void LogFile::Write(std::span<const std::string_view> batch, bool flushNow)
+    {
+        size_t maxFileSize = m_maxFileSize.load(std::memory_order_relaxed);
+        size_t bufferSize = m_bufferSize.load(std::memory_order_relaxed);
+        m_file.SetBufferSize(bufferSize);
+        for (std::string_view msg : batch) {
+            size_t size = m_file.Size();
+            if (maxFileSize > 0 && size > 0 && size + msg.size() > maxFileSize) {
+                Rotate();
+            }
+
+            m_file.Append(msg);
+        }
+
+        m_unsynced = m_unsynced || !batch.empty();
+
+        // without user space buffer, every batch is written to the file like the stream flushed after each batch.
+        if (flushNow || bufferSize == 0) {
+            Flush();
+        } else {
+            FlushIfDue();
+        }
+    }
+
+    void LogFile::FlushIfDue()
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto flushInterval = std::chrono::milliseconds(m_flushInterval.load(std::memory_order_relaxed));
+        if (m_file.HasBufferedData() && flushInterval.count() > 0 && now - m_lastFlush >= flushInterval) {
+            Flush();
+        }
+
+        auto syncInterval = std::chrono::milliseconds(m_syncInterval.load(std::memory_order_relaxed));
+        if (m_unsynced && syncInterval.count() > 0 && now - m_lastSync >= syncInterval) {
+            m_file.Sync();
+            m_unsynced = false;
+            m_lastSync = now;
+        }
+    }
+
+    std::chrono::milliseconds LogFile::GetFlushWaitTime() const
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto flushInterval = std::chrono::milliseconds(m_flushInterval.load(std::memory_order_relaxed));
+        auto syncInterval = std::chrono::milliseconds(m_syncInterval.load(std::memory_order_relaxed));
+        std::chrono::milliseconds waitTime = std::chrono::milliseconds::max();
+        if (m_file.HasBufferedData() && flushInterval.count() > 0) {
+            waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(m_lastFlush + flushInterval - now);
+        }
+
+        if (m_unsynced && syncInterval.count() > 0) {
+            waitTime = std::min(waitTime, std::chrono::duration_cast<std::chrono::milliseconds>(m_lastSync + syncInterval - now));
+        }
+
+        return std::max(waitTime, std::chrono::milliseconds(1));
+    }
+
+    void LogFile::Flush()
+    {
+        m_file.Flush();
+
+        m_lastFlush = std::chrono::steady_clock::now();
+        FlushIfDue();
+    }
+
+    void LogFile::Close()
+    {
+        if (m_file.IsOpen()) {
+            // the logs are synchronized to the disk on closing if the sync is enabled.
+            if (m_syncInterval.load(std::memory_order_relaxed) > 0) {
+                m_file.Sync();
+            }
+
+            m_file.Close();
+            m_unsynced = false;
+        }
+
+        CloseNextFile();
+    }
+
+    void LogFile::SetBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval)
+    {
+        m_bufferSize = bufferSize;
+        m_flushInterval = flushInterval.count();
+    }
+
+    void LogFile::SetSyncInterval(std::chrono::milliseconds syncInterval)
+    {
+        m_syncInterval = syncInterval.count();
+    }
+
+    void LogFile::OpenSegment(const std::string& filePath, FileWriter& file)
+    {
+        file.Open(filePath, m_ioUring.IsInit() ? &m_ioUring : nullptr);
+        file.SetBufferSize(m_bufferSize.load(std::memory_order_relaxed));
+    }
+
+    void LogFile::SetMaxFileSize(size_t maxFileSize)
+    {
+        m_maxFileSize = maxFileSize;
+    }
+
+    void LogFile::SetRetention(size_t maxFileCount, size_t maxTotalBytes)
+    {
+        m_maxFileCount = maxFileCount;
+        m_maxTotalBytes = maxTotalBytes;
+    }
+
+    std::string LogFile::GetSegmentPath(size_t index) const
+    {
+        std::string path = m_dir + "/" + m_date + "_" + m_name;
+        return index == 0 ? path : path + "." + std::to_string(index);
+    }
+
+    // the date of the log file names, like "2023-03-23".
+    static bool IsDate(std::string_view text)
+    {
+        if (text.size() != 10) {
+            return false;
+        }
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            bool valid = i == 4 || i == 7 ? text[i] == '-' : text[i] >= '0' && text[i] <= '9';
+            if (!valid) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    long long LogFile::GetSegmentIndex(const std::string& fileName, const std::string& date) const
+    {
+        // the file name is "<date>_<name>" or "<date>_<name>.<index>", and the date may be any date if it is empty,
+        // the whole name is matched, so the files like "2023-03-23_my_app.log" or "notes_app.log" are not taken as ours.
+        std::string_view rest = fileName;
+        std::string_view prefix = rest.substr(0, date.empty() ? 10 : date.size());
+        if (date.empty() ? !IsDate(prefix) : prefix != date) {
+            return -1;
+        }
+
+        rest.remove_prefix(prefix.size());
+        if (rest.size() <= m_name.size() || rest[0] != '_' || rest.compare(1, m_name.size(), m_name) != 0) {
+            return -1;
+        }
+
+        rest.remove_prefix(m_name.size() + 1);
+        if (rest.empty()) {
+            return 0;
+        }
+
+        // the index has at most 18 digits, so it does not overflow.
+        if (rest[0] != '.' || rest.size() == 1 || rest.size() > 19) {
+            return -1;
+        }
+
+        long long index = 0;
+        for (char c : rest.substr(1)) {
+            if (c < '0' || c > '9') {
+                return -1;
+            }
+
+            index = index * 10 + (c - '0');
+        }
+
+        return index;
+    }
+
+    void LogFile::OpenNextFile()
+    {
+        CloseNextFile();
+        if (m_maxFileSize.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+
+        m_nextFilePath = GetSegmentPath(m_index + 1);
+        OpenSegment(m_nextFilePath, m_nextFile);
+    }
+
+    void LogFile::CloseNextFile()
+    {
+        if (!m_nextFile.IsOpen()) {
+            return;
+        }
+
+        m_nextFile.Close();
+
+        // the next segment is not written yet, remove it to leave no empty file behind.
+        std::error_code ec;
+        if (std::filesystem::file_size(m_nextFilePath, ec) == 0 && !ec) {
+            std::filesystem::remove(m_nextFilePath, ec);
+        }
+    }
+
+    void LogFile::Rotate()
+    {
+        if (!m_nextFile.IsOpen()) {
+            OpenNextFile();
+        }
+
+        if (m_syncInterval.load(std::memory_order_relaxed) > 0) {
+            m_file.Sync();
+            m_unsynced = false;
+        }
+
+        m_file.Close();
+        m_file.Swap(m_nextFile);
+        ++m_index;
+
+        OpenNextFile();
+        ApplyRetention();
+    }
+
+    void LogFile::ApplyRetention()
+    {
+        size_t maxFileCount = m_maxFileCount.load(std::memory_order_relaxed);
+        size_t maxTotalBytes = m_maxTotalBytes.load(std::memory_order_relaxed);
+        if (maxFileCount == 0 && maxTotalBytes == 0) {
+            return;
+        }
+
+        struct FileInfo
+        {
+            std::filesystem::path path;
+            std::filesystem::file_time_type time;
+            std::string date;
+            long long index;
+            size_t size;
+        };
+
+        // the current segment is always kept, and it is counted in the limits.
+        std::vector<FileInfo> files;
+        std::filesystem::path currentPath = std::filesystem::path(GetSegmentPath(m_index)).filename();
+        std::filesystem::path nextPath = std::filesystem::path(GetSegmentPath(m_index + 1)).filename();
+        size_t fileCount = 1;
+        size_t totalBytes = m_file.Size();
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(m_dir, ec)) {
+            std::filesystem::path fileName = entry.path().filename();
+            std::string name = fileName.string();
+            long long index = fileName == currentPath || fileName == nextPath ? -1 : GetSegmentIndex(name, "");
+            if (index < 0 || !entry.is_regular_file(ec)) {
+                continue;
+            }
+
+            FileInfo file{ entry.path(), entry.last_write_time(ec), name.substr(0, 10), index, static_cast<size_t>(entry.file_size(ec)) };
+            files.emplace_back(std::move(file));
+            ++fileCount;
+            totalBytes += files.back().size;
+        }
+
+        // the segments rotated within one tick of a coarse file time tie, they are ordered by their date and index.
+        std::sort(files.begin(), files.end(), [](const FileInfo& lhs, const FileInfo& rhs) {
+            return std::tie(lhs.time, lhs.date, lhs.index) < std::tie(rhs.time, rhs.date, rhs.index);
+        });
+        for (const FileInfo& file : files) {
+            if ((maxFileCount == 0 || fileCount <= maxFileCount) && (maxTotalBytes == 0 || totalBytes <= maxTotalBytes)) {
+                break;
+            }
+
+            if (std::filesystem::remove(file.path, ec)) {
+                --fileCount;
+                totalBytes -= file.size;
+            }
+        }
+    }
+}
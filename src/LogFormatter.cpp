@@ -0,0 +1,279 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "LogFormatter.h"
+
+#include "LogEncoder.h"
+
+#ifdef _MSC_VER
+#define PATH_SEPERATOR '\\'
+#else
+#define PATH_SEPERATOR '/'
+#endif
+
+namespace simple_logger
+{
+    const char* LogLevelToStr(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Debug:
+                return "Debug";
+            case LogLevel::Info:
+                return "Info";
+            case LogLevel::Warn:
+                return "Warn";
+            case LogLevel::Error:
+                return "Error";
+            case LogLevel::Fatal:
+                return "Fatal";
+        }
+
+        return "Unknow";
+    }
+
+    std::string_view GetFileName(std::string_view filePath)
+    {
+        return filePath.substr(filePath.find_last_of(PATH_SEPERATOR) + 1);
+    }
+
+    // the separators of the date time text of DateTimeCache, the digits are '\0' which never match the literals.
+    constexpr std::string_view DATE_TIME_SEPARATORS("\0\0\0\0-\0\0-\0\0 \0\0:\0\0:\0\0.\0\0\0", 23);
+
+    LogPattern::LogPattern(std::string_view pattern) : m_pattern(pattern)
+    {
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] != '%' || i + 1 == pattern.size()) {
+                AddLiteral(pattern.substr(i, 1));
+                continue;
+            }
+
+            char flag = pattern[++i];
+            switch (flag) {
+                case 'Y':
+                    AddDateTime(0, 4);
+                    break;
+                case 'm':
+                    AddDateTime(5, 2);
+                    break;
+                case 'd':
+                    AddDateTime(8, 2);
+                    break;
+                case 'H':
+                    AddDateTime(11, 2);
+                    break;
+                case 'M':
+                    AddDateTime(14, 2);
+                    break;
+                case 'S':
+                    AddDateTime(17, 2);
+                    break;
+                case 'e':
+                    AddDateTime(20, 3);
+                    break;
+                case 'l':
+                    m_ops.push_back({ Field::Level, 0, 0 });
+                    break;
+                case 'L':
+                    m_ops.push_back({ Field::LevelLetter, 0, 0 });
+                    break;
+                case 'n':
+                    m_ops.push_back({ Field::ModuleName, 0, 0 });
+                    break;
+                case 'N':
+                    m_ops.push_back({ Field::ModuleId, 0, 0 });
+                    break;
+                case 'v':
+                    m_ops.push_back({ Field::Message, 0, 0 });
+                    break;
+                case 's':
+                    m_ops.push_back({ Field::FileName, 0, 0 });
+                    break;
+                case 'g':
+                    m_ops.push_back({ Field::FilePath, 0, 0 });
+                    break;
+                case '#':
+                    m_ops.push_back({ Field::Line, 0, 0 });
+                    break;
+                case '!':
+                    m_ops.push_back({ Field::FuncName, 0, 0 });
+                    break;
+                case 't':
+                    m_ops.push_back({ Field::ThreadId, 0, 0 });
+                    break;
+                case 'w':
+                    m_ops.push_back({ Field::ThreadName, 0, 0 });
+                    break;
+                case '%':
+                    AddLiteral("%");
+                    break;
+                default:
+                    AddLiteral(pattern.substr(i - 1, 2));
+                    break;
+            }
+        }
+    }
+
+    void LogPattern::AddLiteral(std::string_view text)
+    {
+        // the adjacent literals are merged into one.
+        if (!m_ops.empty() && m_ops.back().field == Field::Literal) {
+            m_ops.back().size += static_cast<uint32_t>(text.size());
+        } else {
+            m_ops.push_back({ Field::Literal, static_cast<uint32_t>(m_literals.size()), static_cast<uint32_t>(text.size()) });
+        }
+
+        m_literals.append(text);
+    }
+
+    void LogPattern::AddDateTime(uint32_t offset, uint32_t size)
+    {
+        // "%Y-%m-%d" is copied as one part of the date time text, if the literal between the fields is the same
+        // as the separators of the date time text.
+        size_t count = m_ops.size();
+        if (count > 0 && m_ops[count - 1].field == Field::DateTime && m_ops[count - 1].offset + m_ops[count - 1].size == offset) {
+            m_ops[count - 1].size += size;
+            return;
+        }
+
+        if (count > 1 && m_ops[count - 2].field == Field::DateTime && m_ops[count - 1].field == Field::Literal) {
+            const Op& last = m_ops[count - 2];
+            const Op& literal = m_ops[count - 1];
+            uint32_t end = last.offset + last.size;
+            if (end + literal.size == offset && m_literals.compare(literal.offset, literal.size, DATE_TIME_SEPARATORS.substr(end, literal.size)) == 0) {
+                m_literals.resize(literal.offset);
+                m_ops.pop_back();
+                m_ops.back().size += literal.size + size;
+                return;
+            }
+        }
+
+        m_ops.push_back({ Field::DateTime, offset, size });
+    }
+
+    const std::string& LogPattern::GetPattern() const
+    {
+        return m_pattern;
+    }
+
+    void LogPattern::Format(const LogRecord& record, std::string_view dateTime, std::string& out) const
+    {
+        for (const Op& op : m_ops) {
+            switch (op.field) {
+                case Field::Literal:
+                    out.append(m_literals, op.offset, op.size);
+                    break;
+                case Field::DateTime:
+                    out.append(dateTime.substr(op.offset, op.size));
+                    break;
+                case Field::Level:
+                    out.append(LogLevelToStr(record.level));
+                    break;
+                case Field::LevelLetter:
+                    out.push_back(LogLevelToStr(record.level)[0]);
+                    break;
+                case Field::ModuleName:
+                    out.append(record.moduleName);
+                    break;
+                case Field::ModuleId:
+                    AppendInteger(out, record.module);
+                    break;
+                case Field::Message:
+                    out.append(record.message);
+                    break;
+                case Field::FileName:
+                    out.append(GetFileName(record.fileName));
+                    break;
+                case Field::FilePath:
+                    out.append(record.fileName);
+                    break;
+                case Field::Line:
+                    AppendInteger(out, record.line);
+                    break;
+                case Field::FuncName:
+                    out.append(record.funcName);
+                    break;
+                case Field::ThreadId:
+                    AppendInteger(out, record.threadId);
+                    break;
+                case Field::ThreadName:
+                    if (record.threadName != nullptr) {
+                        out.append(record.threadName);
+                    }
+                    break;
+            }
+        }
+    }
+
+    void LogFormatter::Format(const LogRecord& record, const FormatOptions& options, std::string& out)
+    {
+        m_dateTime.Update(record.time);
+        // the encoded logs are always one line each, whatever the write mode is.
+        if (options.encoding == LogEncoding::JsonLines) {
+            EncodeJson(record, m_dateTime.Text(), out);
+            return;
+        }
+
+        if (options.encoding == LogEncoding::Logfmt) {
+            EncodeLogfmt(record, m_dateTime.Text(), out);
+            return;
+        }
+
+        if (options.pattern != nullptr) {
+            options.pattern->Format(record, m_dateTime.Text(), out);
+            if (record.newline) {
+                out.append("\r\n");
+            }
+
+            return;
+        }
+
+        out.append(m_dateTime.Text()).append(" [").append(LogLevelToStr(record.level)).append("] [").append(record.moduleName).append("]");
+        if (options.detailMode) {
+            out.append(" [").append(GetFileName(record.fileName)).append("(line: ");
+            AppendInteger(out, record.line);
+            out.append(", method: ").append(record.funcName).append(", thread: ");
+            AppendInteger(out, record.threadId);
+            if (record.threadName != nullptr) {
+                out.append("/").append(record.threadName);
+            }
+
+            out.append(")]");
+        }
+
+        out.append(": ").append(record.message);
+        if (record.newline) {
+            out.append("\r\n");
+        }
+    }
+
+    void LogFormatter::Format(std::span<const LogRecord> records, const FormatOptions& options, TextBatch& batch)
+    {
+        batch.buffer.clear();
+        batch.logs.clear();
+        batch.metadata.clear();
+        batch.ends.clear();
+        for (const LogRecord& record : records) {
+            Format(record, options, batch.buffer);
+            batch.ends.push_back(batch.buffer.size());
+            batch.metadata.push_back({ record.level, record.module, record.threadId });
+        }
+
+        // the buffer may be reallocated while appending, so the views are made at last.
+        size_t begin = 0;
+        for (size_t end : batch.ends) {
+            batch.logs.emplace_back(batch.buffer.data() + begin, end - begin);
+            begin = end;
+        }
+    }
+}
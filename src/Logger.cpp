@@ -14,35 +14,135 @@
 
 #include "Logger.h"
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <mutex>
-#include <shared_mutex>
-#include <queue>
-#include <iostream>
 #include <sstream>
+#include <vector>
 
+#include "AhoCorasick.h"
+#include "ConsoleWriter.h"
 #include "DateTime.h"
-
-#ifdef _MSC_VER 
-#define PATH_SEPERATOR "\\"
-#else
-#define PATH_SEPERATOR "/"
+#include "FlightRecorder.h"
+#include "LogFile.h"
+#include "LogFormatter.h"
+#include "LogQueue.h"
+#include "SinkWorker.h"
+
+#ifdef linux
+#include <unistd.h>
+#include <sys/syscall.h>
 #endif
 
 namespace simple_logger
 {
-    const char* FONT_STYLE_RED = "\033[31m";
-    const char* FONT_STYLE_GREEN = "\033[32m";
-    const char* FONT_STYLE_YELLOW = "\033[33m";
-    const char* FONT_STYLE_PURPLE = "\033[35m";
-    const char* FONT_STYLE_CYAN = "\033[36m";
-    const char* FONT_STYLE_CLEAR = "\033[0m";
+    // times of checking the queue before the writer thread goes to sleep.
+    constexpr int WRITER_SPIN_COUNT = 64;
+    // times of retrying the full queue before a blocked log writing thread goes to sleep.
+    constexpr int PRODUCER_SPIN_COUNT = 64;
+    // the upper bound of the sleeping of a blocked log writing thread in case of a missing notification.
+    constexpr std::chrono::milliseconds MAX_BLOCKED_WAIT_TIME(100);
+    // the dropped logs are reported at most once in this interval.
+    constexpr std::chrono::seconds DROP_REPORT_INTERVAL(1);
+    // the count of the output types, each of them has a sink worker.
+    constexpr int SINK_NUM = 5;
+    // the upper bound of the distinct source names passed by Log::Write, the names after it are not kept.
+    constexpr size_t MAX_SOURCE_NAME_NUM = 65536;
+    constexpr const char* TOO_MANY_SOURCE_NAMES = "(too many source names)";
+    // the count of the source names cached by each thread.
+    constexpr size_t SOURCE_NAME_CACHE_SIZE = 64;
+
+    // the configuration read by every log, it is immutable once published, the changes are made on a copy,
+    // so the log writing threads read it with one atomic load instead of locking.
+    struct LogConfig
+    {
+        bool detailMode = true;
+        bool colorfulFont = true;       // only use in console terminal.
+        bool reverseFilter = false;     // if reverseFilter == true, only the logs that match filters are printed.
+
+        std::unordered_map<int, const std::string*> modulesMap;
+        std::unordered_set<std::string> andFilters;
+        std::unordered_set<std::string> orFilters;
+        AhoCorasick andMatcher;         // compiled from andFilters.
+        AhoCorasick orMatcher;          // compiled from orFilters.
+        std::unordered_set<int> moduleFilters;
+        // the compiled patterns of the sinks indexed by the bit of the output type, null means the default layout.
+        std::array<std::shared_ptr<const LogPattern>, SINK_NUM> patterns;
+        std::array<LogEncoding, SINK_NUM> encodings {};
+    };
+
+    // the index of the sink of the output type, -1 if it is not a single output type.
+    int GetSinkIndex(OutputType outputType)
+    {
+        for (int i = 0; i < SINK_NUM; ++i) {
+            if (static_cast<uint32_t>(outputType) == (1u << i)) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    uint64_t ToNumericId(std::thread::id threadId)
+    {
+        std::stringstream ss;
+        ss << threadId;
+        uint64_t id = 0;
+        ss >> id;
+        return id;
+    }
+
+    struct ThreadInfo
+    {
+        uint64_t id = 0;
+        const char* name = nullptr;     // interned, never freed.
+    };
+
+    ThreadInfo& GetThreadInfo()
+    {
+        thread_local ThreadInfo info = []() {
+            ThreadInfo threadInfo;
+#ifdef linux
+            threadInfo.id = static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+            // it is the system thread id on windows.
+            threadInfo.id = ToNumericId(std::this_thread::get_id());
+#endif
+            return threadInfo;
+        }();
+
+        return info;
+    }
+
+    // the ids are never reused, unlike the addresses of the logs.
+    uint64_t GetNextLogId()
+    {
+        static std::atomic<uint64_t> nextId = 1;
+        return nextId.fetch_add(1);
+    }
+
+    uint64_t GetCurrentThreadNumericId()
+    {
+        return GetThreadInfo().id;
+    }
+
+    void SetCurrentThreadName(std::string_view name)
+    {
+        // the names are kept forever, so the queued logs can refer to them after the thread exits.
+        static std::mutex namesMutex;
+        static std::unordered_set<std::string> names;
+
+        std::lock_guard<std::mutex> lock(namesMutex);
+        GetThreadInfo().name = name.empty() ? nullptr : names.emplace(name).first->c_str();
+    }
 
     class Log::LogImpl
     {
     public:
-        LogImpl(const char* dir, const char* fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode);
+        LogImpl(LogSwitch& logSwitch, const char* dir, const char* fileName, bool detailMode, QueueType queueType, size_t queueCapacity);
         ~LogImpl();
 
         uint32_t GetOutputFlag() const;
@@ -53,12 +153,21 @@ namespace simple_logger
         bool IsLogSwitchOn(LogLevel level) const;
         void SetLogSwitchOn(LogLevel level);
         void SetLogSwitchOff(LogLevel level);
+        bool IsLogSwitchOn(LogLevel level, int module) const;
+        void SetModuleLevelFlag(int module, uint32_t logLevelFlag);
+        void ClearModuleLevelFlag(int module);
+        void ClearAllModuleLevelFlag();
+        uint32_t GetModuleLevelFlag(int module) const;
         void SetDetailMode(bool enable);
         bool IsDetailMode() const;
         void SetColorfulFont(bool enable);
         bool IsColorfulFont() const;
         void SetReverseFilter(bool enable);
         bool IsReverseFilter() const;
+        void SetPattern(uint32_t outputFlag, const std::string& pattern);
+        std::string GetPattern(OutputType outputType) const;
+        void SetEncoding(OutputType outputType, LogEncoding encoding);
+        LogEncoding GetEncoding(OutputType outputType) const;
 
         void AddModule(int module, const std::string& name);
         void AddModule(const std::unordered_map<int, std::string>& modules);
@@ -88,74 +197,194 @@ namespace simple_logger
         void SetUserWriter(std::shared_ptr<UserDefinedWriter>& m_userWriter);
         void SetRemoteWriter(std::shared_ptr<UserDefinedWriter>& m_remoteWriter);
         bool IsLogQueEmpty() const;
-
-        void Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, const std::string& msg, WriteMode writeMode = WriteMode::Newline);
+        void SetMaxWaitTime(std::chrono::milliseconds maxWaitTime);
+        void SetMaxBatchSize(size_t maxBatchSize);
+        void SetQueueLimit(size_t maxCount, size_t maxBytes);
+        void SetOverflowPolicy(OverflowPolicy policy, LogLevel dropLevel);
+        uint64_t GetDroppedCount() const;
+        void SetSinkQueueLimit(OutputType outputType, size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel);
+        uint64_t GetSinkDroppedCount(OutputType outputType) const;
+        void SetMaxFileSize(size_t maxFileSize);
+        void SetFileRetention(size_t maxFileCount, size_t maxTotalBytes);
+        void SetFileBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval, LogLevel flushLevel);
+        void SetFileSyncInterval(std::chrono::milliseconds syncInterval);
+        bool SetFlightRecorder(const std::string& filePath, size_t capacity);
+
+        // the source strings are interned if internSource is true, otherwise they must be static.
+        // msg is std::string, it is moved into the record if it is an rvalue, otherwise it is copied.
+        template <typename Msg>
+        void Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, bool internSource, std::thread::id threadId,
+            Msg&& msg, WriteMode writeMode);
+        void WriteDeferred(LogLevel level, int module, const LogSource& source, std::thread::id threadId, FormatFunc formatFunc, std::string&& args);
+        void SetDeferredFormat(bool enable);
 
         // Close function should be called munually before the program exit.
         void Close();
 
     public:
-        std::string FormatLog(LogLevel level, int module, std::string_view fileName, int line, std::string_view funcName, uint64_t threadId, const std::string& info);
-        void Write(LogLevel level, WriteMode writeMode, int module, const char* fileName, int line, const char* funcName, uint64_t threadId, const std::string& msg);
+        void PushRecord(LogRecord&& record);
+        bool AcquireQueueSpace(LogRecord& record);
+        void ReleaseQueueSpace(LogRecord& record);
+        // sleep until the writer thread takes logs from the queue after version, or the log is closed.
+        void WaitForQueueSpace(uint64_t version);
+        void NotifyQueueSpace();
+        void ReportDroppedLogs(SinkBatch& batch);
+        bool RenderRecord(LogRecord& record);
 
-        bool NeedFilter(int module, const std::string& msg) const;
         bool NeedFilter(int module) const;
-        bool NeedFilterWithAndRule(const std::string& msg) const;
-        bool NeedFilterWithOrRule(const std::string& msg) const;
-
-        void WriteToConsole(const std::string& msg);
-        void WriteToLogFile(const std::string& msg);
-        void WriteToUserWriter(const std::string& msg);
-        void WriteToRemoteWriter(const std::string& msg);
-        const char* LogLevelToStr(LogLevel level);
+        bool NeedFilter(const LogConfig& config, int module, const std::string& msg) const;
+        bool NeedFilter(const LogConfig& config, int module) const;
+        bool NeedFilterWithAndRule(const LogConfig& config, const std::string& msg) const;
+        bool NeedFilterWithOrRule(const LogConfig& config, const std::string& msg) const;
+
+        void WriteToConsole(const SinkBatch& batch);
+        void WriteToLogFile(const SinkBatch& batch);
+        void WriteToUserWriter(const SinkBatch& batch);
+        void WriteToRemoteWriter(const SinkBatch& batch);
+        void WriteToFlightRecorder(const SinkBatch& batch);
+        void DispatchToSinks(std::shared_ptr<const SinkBatch> batch);
+        const TextBatch& FormatBatch(OutputType outputType, const SinkBatch& batch);
+        SinkWorker* GetSinkWorker(OutputType outputType) const;
         void WritingWorker();
-        void UpdateCurrentDate(const std::string& currentTime);
+        void WaitForLog();
+        void WakeUpWriter();
+        void UpdateCurrentDate(int day);
 
-        std::string GetModuleName(int module) const;
-        const char* GetFontColor(char levelFlag) const;
+        std::shared_ptr<const LogConfig> GetConfig() const;
+        void PublishConfig(std::shared_ptr<const LogConfig> config);
+        template <typename Func>
+        void UpdateConfig(Func&& change);
+
+        const char* InternSourceName(const char* name);
+        std::string_view GetModuleName(const LogConfig& config, int module) const;
+        void SetModuleName(LogConfig& config, int module, const std::string* name);
 
     private:
         std::string m_logDir;
-        std::string m_logFileName;
-        std::string m_currentDate;
 
-        uint32_t m_outputFlag;
-        uint32_t m_logLevelFlag;
+        LogSwitch& m_switch;
 
-        bool m_detailMode = true;
         bool m_exit = false;
-        bool m_stop = false;
-        bool m_dateChanged = false;
-        bool m_colorfulFont = true;     // only use in console terminal.
-        bool m_reverseFilter = false;   // if m_reverseFilter == true, only the logs that match filters are printed.
+        std::atomic<bool> m_stop = false;
+        std::atomic<bool> m_dateChanged = false;
+        std::atomic<int> m_currentDay = 0;
+        DateTimeCache m_dateTime;       // used by the writer thread only.
 
-        std::queue<std::string> m_logQue;
+        std::unique_ptr<LogQueue<LogRecord>> m_logQue;
+        bool m_threadLocalQueue = false;
         std::thread m_writerThread;
-        mutable std::mutex m_writeMutex;
-        mutable std::mutex m_queMutex;
-        mutable std::shared_mutex m_miscMutex;
-
-        std::unordered_map<int, std::string> m_modulesMap;
-        std::unordered_set<std::string> m_andFilters;
-        std::unordered_set<std::string> m_orFilters;
-        std::unordered_set<int> m_moduleFilters;
 
-        std::ofstream m_fileWriter;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wakeCond;
+        std::atomic<bool> m_writerSleeping = false;
+        std::atomic<int64_t> m_maxWaitTime = 300;   // in milliseconds.
+        std::atomic<size_t> m_maxBatchSize = DEFAULT_MAX_BATCH_SIZE;
+
+        std::atomic<size_t> m_maxQueueCount = 0;
+        std::atomic<size_t> m_maxQueueBytes = 0;
+        std::atomic<size_t> m_queuedCount = 0;
+        std::atomic<size_t> m_queuedBytes = 0;
+        std::atomic<OverflowPolicy> m_overflowPolicy = OverflowPolicy::Block;
+        std::atomic<LogLevel> m_dropLevel = LogLevel::Warn;
+        std::atomic<uint64_t> m_droppedCount = 0;
+        uint64_t m_reportedDropCount = 0;   // used by the writer thread only.
+        // the log writing threads blocked by the full queue sleep on m_spaceCond, m_spaceVersion is increased every
+        // time the writer thread takes logs from the queue.
+        std::mutex m_spaceMutex;
+        std::condition_variable m_spaceCond;
+        std::atomic<uint64_t> m_spaceVersion = 0;
+        std::atomic<int> m_spaceWaiters = 0;
+        std::chrono::steady_clock::time_point m_lastDropReport;
+
+        // the readers hold the snapshot they loaded, a replaced config is freed when the last reader releases it.
+        // m_configMutex serializes the writers only.
+        std::mutex m_configMutex;
+#ifdef __cpp_lib_atomic_shared_ptr
+        std::atomic<std::shared_ptr<const LogConfig>> m_config;
+#else
+        std::shared_ptr<const LogConfig> m_config;  // accessed by std::atomic_load and std::atomic_store only.
+#endif
+        // loading the snapshot touches its reference count, so the writing functions skip it when no filter is set.
+        std::atomic<bool> m_filterOn = false;
+
+        // the module names are interned in m_moduleNamePool and never freed before the log is destroyed,
+        // so the readers of m_moduleNames need no locking.
+        std::unordered_set<std::string> m_moduleNamePool;
+        std::array<std::atomic<const std::string*>, MAX_MODULE_NUM> m_moduleNames = {};
+
+        // the file names and the function names passed by Log::Write, they are never freed before the log is destroyed.
+        // the threads cache the names they have interned, so the names passed again are found without locking.
+        const uint64_t m_id;
+        struct NameHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+        };
+        std::mutex m_sourceNameMutex;
+        std::unordered_set<std::string, NameHash, std::equal_to<>> m_sourceNamePool;
+
+        ConsoleWriter m_console;
+        LogFile m_logFile;
+        std::atomic<LogLevel> m_fileFlushLevel = LogLevel::Error;
+        std::mutex m_flightRecorderMutex;
+        FlightRecorder m_flightRecorder;
         std::shared_ptr<UserDefinedWriter> m_userWriter = nullptr;
         std::shared_ptr<UserDefinedWriter> m_remoteWriter = nullptr;   
+
+        // the formatter and the formatted text of a sink, used by its sink worker thread only.
+        struct SinkText
+        {
+            LogFormatter formatter;
+            TextBatch text;
+        };
+
+        // the sink workers and the sink texts are indexed by the bit of the output type.
+        std::array<std::unique_ptr<SinkWorker>, SINK_NUM> m_sinkWorkers;
+        std::array<SinkText, SINK_NUM> m_sinkTexts;
     };
 
-    Log::LogImpl::LogImpl(const char* dir, const char* fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode) :
-        m_logDir(dir), m_logFileName(fileName), m_outputFlag(outputFlag), m_logLevelFlag(logLevelFlag), m_detailMode(detailMode)
+    Log::LogImpl::LogImpl(LogSwitch& logSwitch, const char* dir, const char* fileName, bool detailMode, QueueType queueType, size_t queueCapacity) :
+        m_logDir(dir), m_switch(logSwitch), m_id(GetNextLogId()), m_logFile(dir, fileName)
     {
-        m_currentDate = GetLocalDate();
-        std::string filePath = m_logDir + "/" + m_currentDate + "_" + fileName;
+        auto config = std::make_shared<LogConfig>();
+        config->detailMode = detailMode;
+        PublishConfig(std::move(config));
+
+        switch (queueType) {
+            case QueueType::LockFree:
+                m_logQue = std::make_unique<RingQueue<LogRecord>>(queueCapacity != 0 ? queueCapacity : DEFAULT_QUEUE_CAPACITY);
+                break;
+            case QueueType::ThreadLocal:
+            case QueueType::ThreadLocalOrdered:
+                m_logQue = std::make_unique<ThreadLocalQueue<LogRecord>>(queueCapacity != 0 ? queueCapacity : DEFAULT_THREAD_QUEUE_CAPACITY,
+                    queueType == QueueType::ThreadLocalOrdered);
+                m_threadLocalQueue = true;
+                break;
+            default:
+                m_logQue = std::make_unique<LockedQueue<LogRecord>>();
+                break;
+        }
+
+        DateTimeCache dateTime;
+        dateTime.Update(GetCurrentTime());
+        m_currentDay = dateTime.Day();
 
         if (!std::filesystem::exists(m_logDir)) {
             std::filesystem::create_directory(std::filesystem::path(m_logDir));
         }
 
-        m_fileWriter.open(filePath, std::ios::out | std::ios::app);
+        m_logFile.Open(GetLocalDate());
+
+        m_sinkWorkers[0] = std::make_unique<SinkWorker>([this](const SinkBatch& batch) { WriteToConsole(batch); });
+        m_sinkWorkers[1] = std::make_unique<SinkWorker>([this](const SinkBatch& batch) { WriteToLogFile(batch); },
+            [this]() {
+                // flush the buffered logs of the log file in time.
+                m_logFile.FlushIfDue();
+                return m_logFile.GetFlushWaitTime();
+            });
+        m_sinkWorkers[2] = std::make_unique<SinkWorker>([this](const SinkBatch& batch) { WriteToRemoteWriter(batch); });
+        m_sinkWorkers[3] = std::make_unique<SinkWorker>([this](const SinkBatch& batch) { WriteToUserWriter(batch); });
+        m_sinkWorkers[4] = std::make_unique<SinkWorker>([this](const SinkBatch& batch) { WriteToFlightRecorder(batch); });
 
         m_writerThread = std::thread(&Log::LogImpl::WritingWorker, this);
     }
@@ -167,377 +396,884 @@ namespace simple_logger
 
     uint32_t Log::LogImpl::GetOutputFlag() const
     {
-        return m_outputFlag;
+        return m_switch.outputFlag.load(std::memory_order_relaxed);
     }
 
     bool Log::LogImpl::IsOutputTypeOn(OutputType type) const
     {
-        return (m_outputFlag & ((uint32_t)type)) != 0;
+        return (m_switch.outputFlag.load(std::memory_order_relaxed) & ((uint32_t)type)) != 0;
     }
 
     void Log::LogImpl::SetOutputTypeOn(OutputType outputType)
     {
-        m_outputFlag |= (uint32_t)outputType;
+        m_switch.outputFlag.fetch_or((uint32_t)outputType);
     }
 
     void Log::LogImpl::SetOutputTypeOff(OutputType outputType)
     {
-        m_outputFlag &= ~(uint32_t)outputType;
+        m_switch.outputFlag.fetch_and(~(uint32_t)outputType);
     }
 
     void Log::LogImpl::DisableLog()
     {
-        m_outputFlag = 0;
+        m_switch.outputFlag.store(0);
     }
 
     bool Log::LogImpl::IsLogSwitchOn(LogLevel level) const
     {
-        return (m_logLevelFlag & (uint32_t)level) != 0;
+        return (m_switch.logLevelFlag.load(std::memory_order_relaxed) & (uint32_t)level) != 0;
     }
 
     void Log::LogImpl::SetLogSwitchOn(LogLevel level)
     {
-        m_logLevelFlag |= (uint32_t)level;
+        m_switch.logLevelFlag.fetch_or((uint32_t)level);
     }
 
     void Log::LogImpl::SetLogSwitchOff(LogLevel level)
     {
-        m_logLevelFlag &= ~(uint32_t)level;
+        m_switch.logLevelFlag.fetch_and(~(uint32_t)level);
+    }
+
+    bool Log::LogImpl::IsLogSwitchOn(LogLevel level, int module) const
+    {
+        return (m_switch.GetLevelFlag(module) & (uint32_t)level) != 0;
+    }
+
+    void Log::LogImpl::SetModuleLevelFlag(int module, uint32_t logLevelFlag)
+    {
+        if (module >= 0 && module < MAX_MODULE_NUM) {
+            m_switch.moduleLevelFlag[module].store(logLevelFlag);
+        }
+    }
+
+    void Log::LogImpl::ClearModuleLevelFlag(int module)
+    {
+        SetModuleLevelFlag(module, INHERITED_LEVEL_FLAG);
+    }
+
+    void Log::LogImpl::ClearAllModuleLevelFlag()
+    {
+        for (auto& flag : m_switch.moduleLevelFlag) {
+            flag.store(INHERITED_LEVEL_FLAG);
+        }
+    }
+
+    uint32_t Log::LogImpl::GetModuleLevelFlag(int module) const
+    {
+        return m_switch.GetLevelFlag(module);
+    }
+
+    // the snapshot stays valid as long as the returned pointer is held.
+    std::shared_ptr<const LogConfig> Log::LogImpl::GetConfig() const
+    {
+#ifdef __cpp_lib_atomic_shared_ptr
+        return m_config.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&m_config, std::memory_order_acquire);
+#endif
+    }
+
+    void Log::LogImpl::PublishConfig(std::shared_ptr<const LogConfig> config)
+    {
+#ifdef __cpp_lib_atomic_shared_ptr
+        m_config.store(std::move(config), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&m_config, std::move(config), std::memory_order_release);
+#endif
+    }
+
+    // apply the change on a copy of the current config, then publish the copy.
+    template <typename Func>
+    void Log::LogImpl::UpdateConfig(Func&& change)
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        auto config = std::make_shared<LogConfig>(*GetConfig());
+        change(*config);
+        m_filterOn = !config->moduleFilters.empty() || !config->andFilters.empty() || !config->orFilters.empty();
+        PublishConfig(std::move(config));
     }
 
     void Log::LogImpl::SetDetailMode(bool enable)
     {
-        m_detailMode = enable;
+        UpdateConfig([enable](LogConfig& config) { config.detailMode = enable; });
     }
 
     bool Log::LogImpl::IsDetailMode() const
     {
-        return m_detailMode;
+        return GetConfig()->detailMode;
     }
 
     void Log::LogImpl::SetColorfulFont(bool enable)
     {
-        m_colorfulFont = enable;
+        UpdateConfig([enable](LogConfig& config) { config.colorfulFont = enable; });
     }
 
     bool Log::LogImpl::IsColorfulFont() const
     {
-        return m_colorfulFont;
+        return GetConfig()->colorfulFont;
+    }
+
+    void Log::LogImpl::SetPattern(uint32_t outputFlag, const std::string& pattern)
+    {
+        // compiled once and shared by the sinks.
+        std::shared_ptr<const LogPattern> compiled = pattern.empty() ? nullptr : std::make_shared<const LogPattern>(pattern);
+        UpdateConfig([outputFlag, &compiled](LogConfig& config) {
+            for (int i = 0; i < SINK_NUM; ++i) {
+                if ((outputFlag & (1u << i)) != 0) {
+                    config.patterns[i] = compiled;
+                }
+            }
+        });
+    }
+
+    std::string Log::LogImpl::GetPattern(OutputType outputType) const
+    {
+        int index = GetSinkIndex(outputType);
+        if (index < 0) {
+            return "";
+        }
+
+        std::shared_ptr<const LogPattern> pattern = GetConfig()->patterns[index];
+        return pattern != nullptr ? pattern->GetPattern() : "";
+    }
+
+    void Log::LogImpl::SetEncoding(OutputType outputType, LogEncoding encoding)
+    {
+        int index = GetSinkIndex(outputType);
+        if (index < 0) {
+            return;
+        }
+
+        UpdateConfig([index, encoding](LogConfig& config) { config.encodings[index] = encoding; });
+    }
+
+    LogEncoding Log::LogImpl::GetEncoding(OutputType outputType) const
+    {
+        int index = GetSinkIndex(outputType);
+        return index < 0 ? LogEncoding::Text : GetConfig()->encodings[index];
     }
 
     void Log::LogImpl::SetReverseFilter(bool enable)
     {
-        m_reverseFilter = enable;
+        UpdateConfig([enable](LogConfig& config) { config.reverseFilter = enable; });
     }
 
     bool Log::LogImpl::IsReverseFilter() const
     {
-        return m_reverseFilter;
+        return GetConfig()->reverseFilter;
     }
 
     void Log::LogImpl::AddModule(int module, const std::string& name)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_modulesMap[module] = name;
+        UpdateConfig([this, module, &name](LogConfig& config) {
+            SetModuleName(config, module, &*m_moduleNamePool.insert(name).first);
+        });
     }
 
     void Log::LogImpl::AddModule(const std::unordered_map<int, std::string>& modules)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        std::copy(modules.begin(), modules.end(), std::inserter(m_modulesMap, m_modulesMap.end()));
+        UpdateConfig([this, &modules](LogConfig& config) {
+            for (const auto& [module, name] : modules) {
+                if (config.modulesMap.find(module) == config.modulesMap.end()) {
+                    SetModuleName(config, module, &*m_moduleNamePool.insert(name).first);
+                }
+            }
+        });
     }
 
     void Log::LogImpl::RemoveModule(int module)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_modulesMap.erase(module);
+        UpdateConfig([this, module](LogConfig& config) { SetModuleName(config, module, nullptr); });
     }
 
     void Log::LogImpl::ClearAllModule()
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_modulesMap.clear();
+        UpdateConfig([this](LogConfig& config) {
+            for (auto& name : m_moduleNames) {
+                name.store(nullptr, std::memory_order_release);
+            }
+
+            config.modulesMap.clear();
+        });
+    }
+
+    // it should be called inside UpdateConfig.
+    void Log::LogImpl::SetModuleName(LogConfig& config, int module, const std::string* name)
+    {
+        if (name != nullptr) {
+            config.modulesMap[module] = name;
+        } else {
+            config.modulesMap.erase(module);
+        }
+
+        if (module >= 0 && module < MAX_MODULE_NUM) {
+            m_moduleNames[module].store(name, std::memory_order_release);
+        }
     }
 
     void Log::LogImpl::AddAndFilter(const std::string& filterString)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_andFilters.insert(filterString);
+        UpdateConfig([&filterString](LogConfig& config) {
+            config.andFilters.insert(filterString);
+            config.andMatcher = AhoCorasick(config.andFilters);
+        });
     }
 
     void Log::LogImpl::AddAndFilter(const std::unordered_set<std::string>& filterList)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        std::copy(filterList.begin(), filterList.end(), std::inserter(m_andFilters, m_andFilters.end()));
+        UpdateConfig([&filterList](LogConfig& config) {
+            std::copy(filterList.begin(), filterList.end(), std::inserter(config.andFilters, config.andFilters.end()));
+            config.andMatcher = AhoCorasick(config.andFilters);
+        });
     }
 
     void Log::LogImpl::ClearAndFilter(const std::string& filterString)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_andFilters.erase(filterString);
+        UpdateConfig([&filterString](LogConfig& config) {
+            config.andFilters.erase(filterString);
+            config.andMatcher = AhoCorasick(config.andFilters);
+        });
     }
 
     void Log::LogImpl::ClearAndFilter(const std::unordered_set<std::string>& filterList)
     {
-        std::for_each(filterList.begin(), filterList.end(), [this](const std::string& filterString) { ClearAndFilter(filterString); });
+        UpdateConfig([&filterList](LogConfig& config) {
+            std::for_each(filterList.begin(), filterList.end(), [&config](const std::string& filterString) { config.andFilters.erase(filterString); });
+            config.andMatcher = AhoCorasick(config.andFilters);
+        });
     }
 
     void Log::LogImpl::ClearAndFilter()
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_andFilters.clear();
+        UpdateConfig([](LogConfig& config) {
+            config.andFilters.clear();
+            config.andMatcher = AhoCorasick();
+        });
     }
 
     void Log::LogImpl::AddOrFilter(const std::string& filterString)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_orFilters.insert(filterString);
+        UpdateConfig([&filterString](LogConfig& config) {
+            config.orFilters.insert(filterString);
+            config.orMatcher = AhoCorasick(config.orFilters);
+        });
     }
 
     void Log::LogImpl::AddOrFilter(const std::unordered_set<std::string>& filterList)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        std::copy(filterList.begin(), filterList.end(), std::inserter(m_orFilters, m_orFilters.end()));
+        UpdateConfig([&filterList](LogConfig& config) {
+            std::copy(filterList.begin(), filterList.end(), std::inserter(config.orFilters, config.orFilters.end()));
+            config.orMatcher = AhoCorasick(config.orFilters);
+        });
     }
 
     void Log::LogImpl::ClearOrFilter(const std::string& filterString)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_orFilters.erase(filterString);
+        UpdateConfig([&filterString](LogConfig& config) {
+            config.orFilters.erase(filterString);
+            config.orMatcher = AhoCorasick(config.orFilters);
+        });
     }
 
     void Log::LogImpl::ClearOrFilter(const std::unordered_set<std::string>& filterList)
     {
-        std::for_each(filterList.begin(), filterList.end(), [this](const std::string& filterString) { ClearOrFilter(filterString); });
+        UpdateConfig([&filterList](LogConfig& config) {
+            std::for_each(filterList.begin(), filterList.end(), [&config](const std::string& filterString) { config.orFilters.erase(filterString); });
+            config.orMatcher = AhoCorasick(config.orFilters);
+        });
     }
 
     void Log::LogImpl::ClearOrFilter()
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_orFilters.clear();
+        UpdateConfig([](LogConfig& config) {
+            config.orFilters.clear();
+            config.orMatcher = AhoCorasick();
+        });
     }
 
     void Log::LogImpl::AddModuleFilter(int module)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_moduleFilters.insert(module);
+        UpdateConfig([this, module](LogConfig& config) {
+            config.moduleFilters.insert(module);
+            m_switch.moduleFilterOn = true;
+        });
     }
 
     void Log::LogImpl::AddModuleFilter(const std::unordered_set<int>& moduleList)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        std::copy(moduleList.begin(), moduleList.end(), std::inserter(m_moduleFilters, m_moduleFilters.end()));
+        UpdateConfig([this, &moduleList](LogConfig& config) {
+            std::copy(moduleList.begin(), moduleList.end(), std::inserter(config.moduleFilters, config.moduleFilters.end()));
+            m_switch.moduleFilterOn = !config.moduleFilters.empty();
+        });
     }
 
     void Log::LogImpl::ClearModuleFilter(int module)
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_moduleFilters.erase(module);
+        UpdateConfig([this, module](LogConfig& config) {
+            config.moduleFilters.erase(module);
+            m_switch.moduleFilterOn = !config.moduleFilters.empty();
+        });
     }
 
     void Log::LogImpl::ClearModuleFilter(const std::unordered_set<int>& moduleList)
     {
-        std::for_each(moduleList.begin(), moduleList.end(), [this](int module) { ClearModuleFilter(module); });
+        UpdateConfig([this, &moduleList](LogConfig& config) {
+            std::for_each(moduleList.begin(), moduleList.end(), [&config](int module) { config.moduleFilters.erase(module); });
+            m_switch.moduleFilterOn = !config.moduleFilters.empty();
+        });
     }
 
     void Log::LogImpl::ClearModuleFilter()
     {
-        std::lock_guard<std::shared_mutex> lock(m_miscMutex);
-        m_moduleFilters.clear();
+        UpdateConfig([this](LogConfig& config) {
+            config.moduleFilters.clear();
+            m_switch.moduleFilterOn = false;
+        });
     }
 
     void Log::LogImpl::ClearAllFilter()
     {
-        ClearAndFilter();
-        ClearOrFilter();
-        ClearModuleFilter();
+        UpdateConfig([this](LogConfig& config) {
+            config.andFilters.clear();
+            config.andMatcher = AhoCorasick();
+            config.orFilters.clear();
+            config.orMatcher = AhoCorasick();
+            config.moduleFilters.clear();
+            m_switch.moduleFilterOn = false;
+        });
     }
 
     bool Log::LogImpl::IsLogQueEmpty() const
     {
-        return m_logQue.empty();
+        return m_logQue->Empty();
+    }
+
+    void Log::LogImpl::SetMaxWaitTime(std::chrono::milliseconds maxWaitTime)
+    {
+        m_maxWaitTime = maxWaitTime.count();
+        WakeUpWriter();
+    }
+
+    void Log::LogImpl::SetMaxBatchSize(size_t maxBatchSize)
+    {
+        m_maxBatchSize = std::max<size_t>(maxBatchSize, 1);
+    }
+
+    void Log::LogImpl::SetQueueLimit(size_t maxCount, size_t maxBytes)
+    {
+        m_maxQueueCount = maxCount;
+        m_maxQueueBytes = maxBytes;
+        // the blocked log writing threads check the new limits at once.
+        NotifyQueueSpace();
+    }
+
+    void Log::LogImpl::SetOverflowPolicy(OverflowPolicy policy, LogLevel dropLevel)
+    {
+        m_overflowPolicy = policy;
+        m_dropLevel = dropLevel;
+        NotifyQueueSpace();
+    }
+
+    uint64_t Log::LogImpl::GetDroppedCount() const
+    {
+        return m_droppedCount;
+    }
+
+    void Log::LogImpl::SetSinkQueueLimit(OutputType outputType, size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel)
+    {
+        SinkWorker* sinkWorker = GetSinkWorker(outputType);
+        if (sinkWorker != nullptr) {
+            sinkWorker->SetQueueLimit(maxBatchCount, policy, dropLevel);
+        }
+    }
+
+    uint64_t Log::LogImpl::GetSinkDroppedCount(OutputType outputType) const
+    {
+        SinkWorker* sinkWorker = GetSinkWorker(outputType);
+        return sinkWorker != nullptr ? sinkWorker->GetDroppedCount() : 0;
+    }
+
+    SinkWorker* Log::LogImpl::GetSinkWorker(OutputType outputType) const
+    {
+        int index = GetSinkIndex(outputType);
+        return index >= 0 ? m_sinkWorkers[index].get() : nullptr;
+    }
+
+    void Log::LogImpl::SetMaxFileSize(size_t maxFileSize)
+    {
+        m_logFile.SetMaxFileSize(maxFileSize);
+    }
+
+    void Log::LogImpl::SetFileRetention(size_t maxFileCount, size_t maxTotalBytes)
+    {
+        m_logFile.SetRetention(maxFileCount, maxTotalBytes);
+    }
+
+    void Log::LogImpl::SetFileBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval, LogLevel flushLevel)
+    {
+        m_logFile.SetBufferPolicy(bufferSize, flushInterval);
+        m_fileFlushLevel = flushLevel;
+    }
+
+    void Log::LogImpl::SetFileSyncInterval(std::chrono::milliseconds syncInterval)
+    {
+        m_logFile.SetSyncInterval(syncInterval);
+    }
+
+    bool Log::LogImpl::SetFlightRecorder(const std::string& filePath, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_flightRecorderMutex);
+        return m_flightRecorder.Open(filePath, capacity);
     }
 
     bool Log::LogImpl::NeedFilter(int module) const
     {
-        if (m_moduleFilters.empty()) {
+        return NeedFilter(*GetConfig(), module);
+    }
+
+    bool Log::LogImpl::NeedFilter(const LogConfig& config, int module) const
+    {
+        if (config.moduleFilters.empty()) {
             return false;
         }
 
-        std::shared_lock<std::shared_mutex> lock(m_miscMutex);
-        auto itr = m_moduleFilters.find(module);
-        return m_reverseFilter ? itr == m_moduleFilters.end() : itr != m_moduleFilters.end();
+        auto itr = config.moduleFilters.find(module);
+        return config.reverseFilter ? itr == config.moduleFilters.end() : itr != config.moduleFilters.end();
     }
 
-    bool Log::LogImpl::NeedFilterWithAndRule(const std::string& msg) const
+    bool Log::LogImpl::NeedFilterWithAndRule(const LogConfig& config, const std::string& msg) const
     {
-        if (m_andFilters.empty()) {
+        if (config.andFilters.empty()) {
             return false;
         }
 
-        bool found = false;
-        std::shared_lock<std::shared_mutex> lock(m_miscMutex);
-        for (const std::string& filter : m_andFilters) {
-            if (msg.find(filter) == std::string::npos) {
-                lock.unlock();
-                found = true;
-                break;
-            }
+        bool allFound = config.andMatcher.MatchAll(msg);
+        return config.reverseFilter ? !allFound : allFound;
+    }
+
+    bool Log::LogImpl::NeedFilterWithOrRule(const LogConfig& config, const std::string& msg) const
+    {
+        if (config.orFilters.empty()) {
+            return false;
         }
 
-        return m_reverseFilter ? found : !found;
+        bool found = config.orMatcher.MatchAny(msg);
+        return config.reverseFilter ? !found : found;
     }
 
-    bool Log::LogImpl::NeedFilterWithOrRule(const std::string& msg) const
+    bool Log::LogImpl::NeedFilter(const LogConfig& config, int module, const std::string& msg) const
     {
-        if (m_orFilters.empty()) {
-            return false;
+        return NeedFilter(config, module) || NeedFilterWithAndRule(config, msg) || NeedFilterWithOrRule(config, msg);
+    }
+
+    template <typename Msg>
+    void Log::LogImpl::Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, bool internSource, std::thread::id threadId,
+        Msg&& msg, WriteMode writeMode)
+    {
+        // the cheap checking goes first, the filters need to scan the message.
+        if (m_stop || !IsLogSwitchOn(level, module) || GetOutputFlag() == 0) {
+            return;
         }
 
-        bool found = false;
-        std::shared_lock<std::shared_mutex> lock(m_miscMutex);
-        for (const std::string& filter : m_orFilters) {
-            if (msg.find(filter) != std::string::npos) {
-                lock.unlock();
-                found = true;
-                break;
-            }
+        if (m_filterOn.load(std::memory_order_relaxed) && NeedFilter(*GetConfig(), module, msg)) {
+            return;
+        }
+
+        if (internSource) {
+            fileName = InternSourceName(fileName);
+            funcName = InternSourceName(funcName);
         }
 
-        return m_reverseFilter ? !found : found;
+        LogRecord record;
+        record.time = GetCurrentTime();
+        record.level = level;
+        record.newline = writeMode == WriteMode::Newline;
+        record.module = module;
+        record.fileName = fileName;
+        record.line = line;
+        record.funcName = funcName;
+        // the print micros always pass the current thread id, which is cached.
+        if (threadId == std::this_thread::get_id()) {
+            ThreadInfo& threadInfo = GetThreadInfo();
+            record.threadId = threadInfo.id;
+            record.threadName = threadInfo.name;
+        } else {
+            record.threadId = ToNumericId(threadId);
+        }
+        record.message = std::forward<Msg>(msg);
+        PushRecord(std::move(record));
     }
 
-    bool Log::LogImpl::NeedFilter(int module, const std::string& msg) const
+    const char* Log::LogImpl::InternSourceName(const char* name)
     {
-        return NeedFilter(module) || NeedFilterWithAndRule(msg) || NeedFilterWithOrRule(msg);
+        if (name == nullptr) {
+            return "";
+        }
+
+        // the entry of a name is found by its address, and it is used only if the text is still the same, since
+        // the buffer of the name may be reused for another name. the id tells the logs at the same address apart.
+        struct CacheEntry
+        {
+            uint64_t logId = 0;
+            const char* name = nullptr;
+            const char* interned = nullptr;
+        };
+        thread_local std::array<CacheEntry, SOURCE_NAME_CACHE_SIZE> cache;
+
+        CacheEntry& entry = cache[(reinterpret_cast<uintptr_t>(name) >> 3) % SOURCE_NAME_CACHE_SIZE];
+        if (entry.logId == m_id && entry.name == name && strcmp(entry.interned, name) == 0) {
+            return entry.interned;
+        }
+
+        const char* interned = TOO_MANY_SOURCE_NAMES;
+        {
+            std::lock_guard<std::mutex> lock(m_sourceNameMutex);
+            auto itr = m_sourceNamePool.find(std::string_view(name));
+            if (itr != m_sourceNamePool.end()) {
+                interned = itr->c_str();
+            } else if (m_sourceNamePool.size() < MAX_SOURCE_NAME_NUM) {
+                interned = m_sourceNamePool.emplace(name).first->c_str();
+            } else {
+                return interned;
+            }
+        }
+
+        entry = { m_id, name, interned };
+        return interned;
     }
 
-    void Log::LogImpl::Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, const std::string& msg, WriteMode writeMode)
+    void Log::LogImpl::WriteDeferred(LogLevel level, int module, const LogSource& source, std::thread::id threadId, FormatFunc formatFunc, std::string&& args)
     {
-        if (NeedFilter(module, msg)) {
+        if (m_stop || !IsLogSwitchOn(level, module) || GetOutputFlag() == 0
+            || (m_filterOn.load(std::memory_order_relaxed) && NeedFilter(*GetConfig(), module))) {
             return;
         }
 
-        std::stringstream ss;
-        ss << threadId;
-        uint64_t id = 0;
-        ss >> id;
+        LogRecord record;
+        record.time = GetCurrentTime();
+        record.level = level;
+        record.module = module;
+        record.fileName = source.fileName;
+        record.line = source.line;
+        record.funcName = source.funcName;
+        if (threadId == std::this_thread::get_id()) {
+            ThreadInfo& threadInfo = GetThreadInfo();
+            record.threadId = threadInfo.id;
+            record.threadName = threadInfo.name;
+        } else {
+            record.threadId = ToNumericId(threadId);
+        }
+        record.message = std::move(args);
+        record.formatFunc = formatFunc;
+        record.fmt = source.fmt;
+        PushRecord(std::move(record));
+    }
 
-        Write(level, writeMode, module, fileName, line, funcName, id, msg);
+    void Log::LogImpl::SetDeferredFormat(bool enable)
+    {
+        m_switch.deferredFormat = enable;
     }
 
-    void Log::LogImpl::UpdateCurrentDate(const std::string& currentTime)
+    void Log::LogImpl::UpdateCurrentDate(int day)
     {
-        if (currentTime[9] != m_currentDate[9]) {
-            m_currentDate = currentTime.substr(0, 10);
+        // the deferred format logs may come a little out of order, so the date only moves forward.
+        if (day > m_currentDay.load(std::memory_order_relaxed)) {
+            m_currentDay = day;
             m_dateChanged = true;
         }
     }
 
-    std::string Log::LogImpl::FormatLog(LogLevel level, int module, const std::string_view fileName, int line, const std::string_view funcName, uint64_t threadId, const std::string& info)
+    void Log::LogImpl::PushRecord(LogRecord&& record)
+    {
+        for (int retry = 0; ; ++retry) {
+            if (m_stop) {
+                return;
+            }
+
+            uint64_t spaceVersion = m_spaceVersion.load();
+
+            if (AcquireQueueSpace(record)) {
+                if (m_logQue->Push(std::move(record))) {
+                    break;
+                }
+
+                ReleaseQueueSpace(record);
+            }
+
+            // the queue is full.
+            OverflowPolicy policy = m_overflowPolicy;
+            if (policy == OverflowPolicy::DropNewest || (policy == OverflowPolicy::DropOldest && m_threadLocalQueue)
+                || (policy == OverflowPolicy::DropBelowLevel && static_cast<int>(record.level) < static_cast<int>(m_dropLevel.load()))) {
+                ++m_droppedCount;
+                return;
+            }
+
+            // the thread local queues can be popped by the writer thread only.
+            LogRecord oldest;
+            if (policy == OverflowPolicy::DropOldest && m_logQue->Pop(oldest)) {
+                ReleaseQueueSpace(oldest);
+                ++m_droppedCount;
+                continue;
+            }
+
+            if (retry < PRODUCER_SPIN_COUNT) {
+                std::this_thread::yield();
+            } else {
+                WaitForQueueSpace(spaceVersion);
+            }
+        }
+
+        // pairs with the storing of m_writerSleeping in WaitForLog, either the writer sees the new log,
+        // or the log writing thread sees the writer is sleeping.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_writerSleeping.load(std::memory_order_relaxed)) {
+            WakeUpWriter();
+        }
+    }
+
+    bool Log::LogImpl::AcquireQueueSpace(LogRecord& record)
     {
-        std::string currentTime = GetLocalDateTimeWithMilliSecond();
-        UpdateCurrentDate(currentTime);
+        size_t maxCount = m_maxQueueCount;
+        size_t maxBytes = m_maxQueueBytes;
+        if (maxCount == 0 && maxBytes == 0) {
+            return true;
+        }
 
-        if (!m_detailMode) {
-            return FORMAT("{} [{}] [{}]: {}", currentTime, LogLevelToStr(level), GetModuleName(module), info);
+        // add first then check, so that the concurrent writing threads can not exceed the limit together.
+        // a log larger than maxBytes is still accepted by the empty queue.
+        size_t count = m_queuedCount.fetch_add(1) + 1;
+        size_t bytes = m_queuedBytes.fetch_add(record.message.size()) + record.message.size();
+        if ((maxCount != 0 && count > maxCount) || (maxBytes != 0 && bytes > maxBytes && count > 1)) {
+            m_queuedCount.fetch_sub(1);
+            m_queuedBytes.fetch_sub(record.message.size());
+            return false;
         }
 
-        return FORMAT("{} [{}] [{}] [{}(line: {}, method: {}, thread: {})]: {}",
-            currentTime, LogLevelToStr(level), GetModuleName(module), fileName.substr(fileName.find_last_of(PATH_SEPERATOR) + 1), line, funcName, threadId, info);
+        record.counted = true;
+        return true;
     }
 
-    void Log::LogImpl::Write(LogLevel level, WriteMode writeMode, int module, const char* fileName, int line, const char* funcName, uint64_t threadId, const std::string& msg)
+    void Log::LogImpl::ReleaseQueueSpace(LogRecord& record)
     {
-        if (m_stop || !IsLogSwitchOn(level)) {
+        if (!record.counted) {
             return;
         }
 
-        std::string&& str = FormatLog(level, module, fileName, line, funcName, threadId, msg);
-        if (writeMode == WriteMode::Newline) {
-            str.append("\r\n");
+        record.counted = false;
+        m_queuedCount.fetch_sub(1);
+        m_queuedBytes.fetch_sub(record.message.size());
+    }
+
+    void Log::LogImpl::WaitForQueueSpace(uint64_t version)
+    {
+        std::unique_lock<std::mutex> lock(m_spaceMutex);
+        // pairs with NotifyQueueSpace, either the writer thread sees the waiter, or the waiter sees the new version.
+        m_spaceWaiters.fetch_add(1);
+        m_spaceCond.wait_for(lock, MAX_BLOCKED_WAIT_TIME, [this, version] { return m_spaceVersion.load() != version || m_stop; });
+        m_spaceWaiters.fetch_sub(1);
+    }
+
+    void Log::LogImpl::NotifyQueueSpace()
+    {
+        m_spaceVersion.fetch_add(1);
+        if (m_spaceWaiters.load() > 0) {
+            // lock to make sure the waiter is either waiting or has not checked the version yet.
+            std::lock_guard<std::mutex> lock(m_spaceMutex);
+            m_spaceCond.notify_all();
+        }
+    }
+
+    void Log::LogImpl::ReportDroppedLogs(SinkBatch& batch)
+    {
+        uint64_t droppedCount = m_droppedCount;
+        if (droppedCount == m_reportedDropCount) {
+            return;
         }
 
-        std::unique_lock<std::mutex> lock(m_queMutex);
-        m_logQue.emplace(str);
+        auto now = std::chrono::steady_clock::now();
+        if (now - m_lastDropReport < DROP_REPORT_INTERVAL && !m_stop) {
+            return;
+        }
 
-        return;
+        LogRecord record;
+        record.time = GetCurrentTime();
+        record.level = LogLevel::Warn;
+        record.module = -1;
+        record.moduleName = GetModuleName(*GetConfig(), record.module);
+        record.fileName = __FILE__;
+        record.line = __LINE__;
+        record.funcName = __FUNCTION__;
+        record.threadId = GetCurrentThreadNumericId();
+        record.message = FORMAT("{} logs are dropped because the log queue is full", droppedCount - m_reportedDropCount);
+        batch.records.emplace_back(std::move(record));
+        batch.maxLevel = std::max(batch.maxLevel, LogLevel::Warn);
+        m_reportedDropCount = droppedCount;
+        m_lastDropReport = now;
     }
 
     void Log::LogImpl::WritingWorker()
     {
-        std::unique_lock<std::mutex> locker(m_queMutex, std::defer_lock);
+        std::vector<LogRecord> records;
         while (!m_exit) {
-            if (m_logQue.empty()) {
+            records.clear();
+            size_t count = m_logQue->PopBatch(records, m_maxBatchSize);
+            auto batch = std::make_shared<SinkBatch>();
+            batch->records.reserve(count);
+            for (LogRecord& record : records) {
+                ReleaseQueueSpace(record);
+
+                if (RenderRecord(record)) {
+                    batch->maxLevel = std::max(batch->maxLevel, record.level);
+                    batch->records.emplace_back(std::move(record));
+                }
+            }
+
+            if (count > 0) {
+                NotifyQueueSpace();
+            }
+
+            ReportDroppedLogs(*batch);
+
+            if (!batch->records.empty()) {
+                DispatchToSinks(std::move(batch));
+            }
+
+            if (count == 0) {
                 if (m_stop) {
                     break;
                 }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(300));
-                continue;
+                WaitForLog();
+            }
+        }
+    }
+
+    void Log::LogImpl::DispatchToSinks(std::shared_ptr<const SinkBatch> batch)
+    {
+        // the batch is shared by the sink workers, each of them writes one output terminal.
+        uint32_t outputFlag = GetOutputFlag();
+        for (int i = 0; i < SINK_NUM; ++i) {
+            if ((outputFlag & (1u << i)) != 0) {
+                m_sinkWorkers[i]->Push(batch);
             }
+        }
+    }
 
-            locker.lock();
-            std::string logStr = std::move(m_logQue.front());
-            m_logQue.pop();
-            locker.unlock();
+    bool Log::LogImpl::RenderRecord(LogRecord& record)
+    {
+        std::shared_ptr<const LogConfig> snapshot = GetConfig();
+        const LogConfig& config = *snapshot;
+        if (record.formatFunc != nullptr) {
+            std::string msg;
+            try {
+                record.formatFunc(record.fmt, record.message.data(), msg);
+            } catch (const std::exception& e) {
+                msg = FORMAT("Invalid formatting: {}, format={}", e.what(), record.fmt);
+            }
 
-            // Only one writing thread, no need to lock for the below action.
-            WriteToConsole(logStr);
-            WriteToLogFile(logStr);
-            WriteToUserWriter(logStr);
-            WriteToRemoteWriter(logStr);
+            if (NeedFilterWithAndRule(config, msg) || NeedFilterWithOrRule(config, msg)) {
+                return false;
+            }
+
+            record.message = std::move(msg);
+            record.formatFunc = nullptr;
         }
+
+        m_dateTime.Update(record.time);
+        UpdateCurrentDate(m_dateTime.Day());
+        record.moduleName = GetModuleName(config, record.module);
+        return true;
     }
 
-    void Log::LogImpl::WriteToConsole(const std::string& msg)
+    const TextBatch& Log::LogImpl::FormatBatch(OutputType outputType, const SinkBatch& batch)
     {
-        if (!IsOutputTypeOn(OutputType::Console)) {
-            return;
+        std::shared_ptr<const LogConfig> snapshot = GetConfig();
+        const LogConfig& config = *snapshot;
+        int index = GetSinkIndex(outputType);
+        SinkText& sinkText = m_sinkTexts[index];
+        FormatOptions options { config.patterns[index].get(), config.detailMode, config.encodings[index] };
+        sinkText.formatter.Format(batch.records, options, sinkText.text);
+        return sinkText.text;
+    }
+
+    void Log::LogImpl::WaitForLog()
+    {
+        for (int i = 0; i < WRITER_SPIN_COUNT; ++i) {
+            if (!m_logQue->Empty() || m_stop) {
+                return;
+            }
+
+            std::this_thread::yield();
         }
 
-        if (!m_colorfulFont) {
-            std::unique_lock<std::mutex> lock(m_writeMutex);
-            std::cout << msg;
-            return;
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_writerSleeping.store(true);
+        if (m_logQue->Empty() && !m_stop) {
+            int64_t maxWaitTime = m_maxWaitTime;
+            if (maxWaitTime > 0) {
+                m_wakeCond.wait_for(lock, std::chrono::milliseconds(maxWaitTime));
+            } else {
+                m_wakeCond.wait(lock);
+            }
         }
 
-        std::string coloredMsg = FORMAT("{}{}{}", GetFontColor(msg[25]), msg, FONT_STYLE_CLEAR);
-        std::unique_lock<std::mutex> lock(m_writeMutex);
-        std::cout << coloredMsg;
+        m_writerSleeping.store(false, std::memory_order_relaxed);
     }
 
-    void Log::LogImpl::WriteToLogFile(const std::string& msg)
+    void Log::LogImpl::WakeUpWriter()
     {
-        if (!IsOutputTypeOn(OutputType::LogFile)) {
-            return;
-        }
+        // lock to make sure the writer is either waiting or has not checked the queue yet.
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCond.notify_one();
+    }
+
+    void Log::LogImpl::WriteToConsole(const SinkBatch& batch)
+    {
+        const TextBatch& text = FormatBatch(OutputType::Console, batch);
+        // the color codes would break the encoded logs.
+        std::shared_ptr<const LogConfig> snapshot = GetConfig();
+        const LogConfig& config = *snapshot;
+        bool colorful = config.colorfulFont && config.encodings[GetSinkIndex(OutputType::Console)] == LogEncoding::Text;
+        m_console.Write(text.logs, text.metadata, colorful);
+    }
 
-        if (m_dateChanged) {
-            m_fileWriter.close();
-            m_fileWriter.open(m_logDir + m_currentDate + "_" + m_logFileName, std::ios::out | std::ios::app);
-            m_dateChanged = false;
+    void Log::LogImpl::WriteToLogFile(const SinkBatch& batch)
+    {
+        if (m_dateChanged.exchange(false)) {
+            m_logFile.Open(GetLocalDate());
         }
 
-        m_fileWriter << msg;        
+        const TextBatch& text = FormatBatch(OutputType::LogFile, batch);
+        m_logFile.Write(text.logs, batch.maxLevel >= m_fileFlushLevel.load());
     }
 
-    void Log::LogImpl::WriteToUserWriter(const std::string& msg)
+    void Log::LogImpl::WriteToUserWriter(const SinkBatch& batch)
     {
-        if (!IsOutputTypeOn(OutputType::UserDefined) || m_userWriter == nullptr) {
+        if (m_userWriter == nullptr) {
             return;
         }
 
-        m_userWriter->Write(msg);
+        const TextBatch& text = FormatBatch(OutputType::UserDefined, batch);
+        m_userWriter->WriteBatch(text.logs, text.metadata);
     }
 
-    void Log::LogImpl::WriteToRemoteWriter(const std::string& msg)
+    void Log::LogImpl::WriteToRemoteWriter(const SinkBatch& batch)
     {
-        if (!IsOutputTypeOn(OutputType::RemoteServer) || m_remoteWriter == nullptr) {
+        if (m_remoteWriter == nullptr) {
             return;
         }
 
-        m_remoteWriter->Write(msg);
+        const TextBatch& text = FormatBatch(OutputType::RemoteServer, batch);
+        m_remoteWriter->WriteBatch(text.logs, text.metadata);
+    }
+
+    void Log::LogImpl::WriteToFlightRecorder(const SinkBatch& batch)
+    {
+        const TextBatch& text = FormatBatch(OutputType::FlightRecorder, batch);
+        std::lock_guard<std::mutex> lock(m_flightRecorderMutex);
+        for (std::string_view msg : text.logs) {
+            m_flightRecorder.Write(msg);
+        }
     }
 
     void Log::LogImpl::SetUserWriter(std::shared_ptr<UserDefinedWriter>& m_fileWriter)
@@ -550,29 +1286,15 @@ namespace simple_logger
         m_remoteWriter = m_fileWriter;
     }
 
-    const char* Log::LogImpl::LogLevelToStr(LogLevel level)
+    std::string_view Log::LogImpl::GetModuleName(const LogConfig& config, int module) const
     {
-        switch (level) {
-            case LogLevel::Debug:
-                return "Debug";
-            case LogLevel::Info:
-                return "Info";
-            case LogLevel::Warn:
-                return "Warn";
-            case LogLevel::Error:
-                return "Error";
-            case LogLevel::Fatal:
-                return "Fatal";
+        if (module >= 0 && module < MAX_MODULE_NUM) {
+            const std::string* name = m_moduleNames[module].load(std::memory_order_acquire);
+            return name != nullptr ? std::string_view(*name) : std::string_view();
         }
 
-        return "Unknow";
-    }
-
-    std::string Log::LogImpl::GetModuleName(int module) const
-    {
-        std::shared_lock<std::shared_mutex> lock(m_miscMutex);
-        auto itr = m_modulesMap.find(module); 
-        return itr != m_modulesMap.end() ? itr->second : "";
+        auto itr = config.modulesMap.find(module);
+        return itr != config.modulesMap.end() ? std::string_view(*itr->second) : std::string_view();
     }
 
     void Log::LogImpl::Close()
@@ -582,13 +1304,24 @@ namespace simple_logger
         }
 
         m_stop = true;
+        WakeUpWriter();
+        NotifyQueueSpace();
 
         if (m_writerThread.joinable()) {
             m_writerThread.join();
         }
 
-        m_fileWriter.flush();
-        m_fileWriter.close();
+        // the sink workers write the batches left in their queues before they stop.
+        for (auto& sinkWorker : m_sinkWorkers) {
+            sinkWorker->Stop();
+        }
+
+        m_logFile.Close();
+
+        {
+            std::lock_guard<std::mutex> lock(m_flightRecorderMutex);
+            m_flightRecorder.Close();
+        }
 
         if (m_userWriter != nullptr) {
             m_userWriter->Close();
@@ -601,33 +1334,14 @@ namespace simple_logger
         m_exit = true;
     }
 
-    const char* Log::LogImpl::GetFontColor(char levelFlag) const
-    {
-        switch (levelFlag) {
-            case 'D':   // debug level
-                return FONT_STYLE_GREEN;
-            case 'I':   // info level
-                return FONT_STYLE_CYAN;
-            case 'W':   // warning level
-                return FONT_STYLE_YELLOW;
-            case 'E':   // error level
-                return FONT_STYLE_RED;
-            case 'F':   // fatal level
-                return FONT_STYLE_PURPLE;
-            default:
-                return FONT_STYLE_CLEAR;
-        }
-    }
-
-
     // Log public function implementation.
-    Log::Log(const char* dir, const char* fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode) :
-        m_impl(std::make_unique<Log::LogImpl>(dir, fileName, outputFlag, logLevelFlag, detailMode))
+    Log::Log(const char* dir, const char* fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode, QueueType queueType, size_t queueCapacity) :
+        m_switch(outputFlag, logLevelFlag), m_impl(std::make_unique<Log::LogImpl>(m_switch, dir, fileName, detailMode, queueType, queueCapacity))
     {
     }
 
-    Log::Log(std::string_view dir, std::string_view fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode) :
-        m_impl(std::make_unique<Log::LogImpl>(dir.data(), fileName.data(), outputFlag, logLevelFlag, detailMode))
+    Log::Log(std::string_view dir, std::string_view fileName, uint32_t outputFlag, uint32_t logLevelFlag, bool detailMode, QueueType queueType, size_t queueCapacity) :
+        m_switch(outputFlag, logLevelFlag), m_impl(std::make_unique<Log::LogImpl>(m_switch, dir.data(), fileName.data(), detailMode, queueType, queueCapacity))
     {
     }
 
@@ -676,6 +1390,26 @@ namespace simple_logger
         m_impl->SetLogSwitchOff(level);
     }
 
+    void Log::SetModuleLevelFlag(int module, uint32_t logLevelFlag)
+    {
+        m_impl->SetModuleLevelFlag(module, logLevelFlag);
+    }
+
+    void Log::ClearModuleLevelFlag(int module)
+    {
+        m_impl->ClearModuleLevelFlag(module);
+    }
+
+    void Log::ClearAllModuleLevelFlag()
+    {
+        m_impl->ClearAllModuleLevelFlag();
+    }
+
+    uint32_t Log::GetModuleLevelFlag(int module) const
+    {
+        return m_impl->GetModuleLevelFlag(module);
+    }
+
     void Log::SetDetailMode(bool enable)
     {
         m_impl->SetDetailMode(enable);
@@ -696,6 +1430,31 @@ namespace simple_logger
         return m_impl->IsColorfulFont();
     }
 
+    void Log::SetPattern(const std::string& pattern)
+    {
+        m_impl->SetPattern(0xFFFFFFFF, pattern);
+    }
+
+    void Log::SetPattern(OutputType outputType, const std::string& pattern)
+    {
+        m_impl->SetPattern(static_cast<uint32_t>(outputType), pattern);
+    }
+
+    std::string Log::GetPattern(OutputType outputType) const
+    {
+        return m_impl->GetPattern(outputType);
+    }
+
+    void Log::SetEncoding(OutputType outputType, LogEncoding encoding)
+    {
+        m_impl->SetEncoding(outputType, encoding);
+    }
+
+    LogEncoding Log::GetEncoding(OutputType outputType) const
+    {
+        return m_impl->GetEncoding(outputType);
+    }
+
     void Log::SetReverseFilter(bool enable)
     {
         m_impl->SetReverseFilter(enable);
@@ -821,9 +1580,99 @@ namespace simple_logger
         return m_impl->IsLogQueEmpty();
     }
 
+    void Log::SetMaxWaitTime(std::chrono::milliseconds maxWaitTime)
+    {
+        m_impl->SetMaxWaitTime(maxWaitTime);
+    }
+
+    void Log::SetMaxBatchSize(size_t maxBatchSize)
+    {
+        m_impl->SetMaxBatchSize(maxBatchSize);
+    }
+
+    void Log::SetQueueLimit(size_t maxCount, size_t maxBytes)
+    {
+        m_impl->SetQueueLimit(maxCount, maxBytes);
+    }
+
+    void Log::SetOverflowPolicy(OverflowPolicy policy, LogLevel dropLevel)
+    {
+        m_impl->SetOverflowPolicy(policy, dropLevel);
+    }
+
+    uint64_t Log::GetDroppedCount() const
+    {
+        return m_impl->GetDroppedCount();
+    }
+
+    void Log::SetSinkQueueLimit(OutputType outputType, size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel)
+    {
+        m_impl->SetSinkQueueLimit(outputType, maxBatchCount, policy, dropLevel);
+    }
+
+    uint64_t Log::GetSinkDroppedCount(OutputType outputType) const
+    {
+        return m_impl->GetSinkDroppedCount(outputType);
+    }
+
+    void Log::SetMaxFileSize(size_t maxFileSize)
+    {
+        m_impl->SetMaxFileSize(maxFileSize);
+    }
+
+    void Log::SetFileRetention(size_t maxFileCount, size_t maxTotalBytes)
+    {
+        m_impl->SetFileRetention(maxFileCount, maxTotalBytes);
+    }
+
+    void Log::SetFileBufferPolicy(size_t bufferSize, std::chrono::milliseconds flushInterval, LogLevel flushLevel)
+    {
+        m_impl->SetFileBufferPolicy(bufferSize, flushInterval, flushLevel);
+    }
+
+    void Log::SetFileSyncInterval(std::chrono::milliseconds syncInterval)
+    {
+        m_impl->SetFileSyncInterval(syncInterval);
+    }
+
+    bool Log::SetFlightRecorder(const std::string& filePath, size_t capacity)
+    {
+        return m_impl->SetFlightRecorder(filePath, capacity);
+    }
+
+    bool Log::NeedFilter(int module) const
+    {
+        return m_impl->NeedFilter(module);
+    }
+
     void Log::Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, const std::string& msg, WriteMode writeMode)
     {
-        m_impl->Write(level, module, fileName, line, funcName, threadId, msg, writeMode);
+        m_impl->Write(level, module, fileName, line, funcName, true, threadId, msg, writeMode);
+    }
+
+    void Log::Write(LogLevel level, int module, const LogSource& source, std::thread::id threadId, const std::string& msg, WriteMode writeMode)
+    {
+        m_impl->Write(level, module, source.fileName, source.line, source.funcName, false, threadId, msg, writeMode);
+    }
+
+    void Log::Write(LogLevel level, int module, const char* fileName, int line, const char* funcName, std::thread::id threadId, std::string&& msg, WriteMode writeMode)
+    {
+        m_impl->Write(level, module, fileName, line, funcName, true, threadId, std::move(msg), writeMode);
+    }
+
+    void Log::Write(LogLevel level, int module, const LogSource& source, std::thread::id threadId, std::string&& msg, WriteMode writeMode)
+    {
+        m_impl->Write(level, module, source.fileName, source.line, source.funcName, false, threadId, std::move(msg), writeMode);
+    }
+
+    void Log::SetDeferredFormat(bool enable)
+    {
+        m_impl->SetDeferredFormat(enable);
+    }
+
+    void Log::WriteDeferred(LogLevel level, int module, const LogSource& source, std::thread::id threadId, FormatFunc formatFunc, std::string&& args)
+    {
+        m_impl->WriteDeferred(level, module, source, threadId, formatFunc, std::move(args));
     }
 
     void Log::Close()
@@ -0,0 +1,133 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SinkWorker.h"
+
+#include <algorithm>
+
+namespace simple_logger
+{
+    SinkWorker::SinkWorker(WriteFunc writeFunc, IdleFunc idleFunc) : m_writeFunc(std::move(writeFunc)), m_idleFunc(std::move(idleFunc))
+    {
+    }
+
+    SinkWorker::~SinkWorker()
+    {
+        Stop();
+    }
+
+    void SinkWorker::SetQueueLimit(size_t maxBatchCount, OverflowPolicy policy, LogLevel dropLevel)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxBatchCount = std::max<size_t>(maxBatchCount, 1);
+        m_overflowPolicy = policy;
+        m_dropLevel = dropLevel;
+        m_notFull.notify_all();
+    }
+
+    void SinkWorker::Push(const std::shared_ptr<const SinkBatch>& batch)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            return;
+        }
+
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&SinkWorker::Run, this);
+        }
+
+        if (m_batches.size() >= m_maxBatchCount) {
+            switch (m_overflowPolicy) {
+                case OverflowPolicy::DropNewest:
+                    m_droppedCount += batch->records.size();
+                    return;
+                case OverflowPolicy::DropOldest:
+                    m_droppedCount += m_batches.front()->records.size();
+                    m_batches.pop_front();
+                    break;
+                case OverflowPolicy::DropBelowLevel:
+                    if (batch->maxLevel < m_dropLevel) {
+                        m_droppedCount += batch->records.size();
+                        return;
+                    }
+
+                    [[fallthrough]];
+                default:
+                    m_notFull.wait(lock, [this]() { return m_batches.size() < m_maxBatchCount || m_stop; });
+                    break;
+            }
+        }
+
+        m_batches.push_back(batch);
+        m_notEmpty.notify_one();
+    }
+
+    void SinkWorker::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_notEmpty.notify_one();
+            m_notFull.notify_all();
+        }
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    uint64_t SinkWorker::GetDroppedCount() const
+    {
+        return m_droppedCount;
+    }
+
+    void SinkWorker::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            if (m_batches.empty()) {
+                if (m_stop) {
+                    break;
+                }
+
+                if (m_idleFunc == nullptr) {
+                    m_notEmpty.wait(lock);
+                    continue;
+                }
+
+                lock.unlock();
+                std::chrono::milliseconds waitTime = m_idleFunc();
+                lock.lock();
+                if (m_batches.empty() && !m_stop) {
+                    if (waitTime == std::chrono::milliseconds::max()) {
+                        m_notEmpty.wait(lock);
+                    } else {
+                        m_notEmpty.wait_for(lock, waitTime);
+                    }
+                }
+
+                continue;
+            }
+
+            std::shared_ptr<const SinkBatch> batch = std::move(m_batches.front());
+            m_batches.pop_front();
+            m_notFull.notify_one();
+
+            lock.unlock();
+            m_writeFunc(*batch);
+            batch.reset();
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// the compile time level of this file is Warn whatever the cmake option is, the print micros are expanded in it.
+#undef SIMPLE_LOGGER_ACTIVE_LEVEL
+#define SIMPLE_LOGGER_ACTIVE_LEVEL SIMPLE_LOGGER_LEVEL_WARN
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "Check.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+
+class CountingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        (void)str;
+        ++count;
+    }
+
+    std::atomic<int> count = 0;
+};
+
+int main()
+{
+    auto writer = std::make_shared<CountingWriter>();
+    // all the levels are on at runtime, only the compile time level strips the logs.
+    Log log(".", "active_level_test", MakeFlag(OutputType::UserDefined),
+        MakeFlag(LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal));
+    log.SetUserWriter(writer);
+
+    int evaluated = 0;
+    DBG_DEBUG(log, 0, "{}", ++evaluated);
+    DBG_INFO(log, 0, "{}", ++evaluated);
+    CHECK(evaluated == 0);
+
+    DBG_WARN(log, 0, "{}", ++evaluated);
+    DBG_ERROR(log, 0, "{}", ++evaluated);
+    DBG_FATAL(log, 0, "{}", ++evaluated);
+    CHECK(evaluated == 3);
+
+    // the same in deferred format mode.
+    log.SetDeferredFormat(true);
+    DBG_DEBUG(log, 0, "{}", ++evaluated);
+    DBG_INFO(log, 0, "{}", ++evaluated);
+    DBG_WARN(log, 0, "{}", ++evaluated);
+    CHECK(evaluated == 4);
+
+    log.Close();
+    CHECK(writer->count == 4);
+    return g_failedChecks;
+}
@@ -0,0 +1,112 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <random>
+#include <string>
+#include <unordered_set>
+
+#include "AhoCorasick.h"
+#include "Check.h"
+
+using namespace simple_logger;
+
+static bool FindAny(const std::unordered_set<std::string>& patterns, const std::string& text)
+{
+    for (const std::string& pattern : patterns) {
+        if (text.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool FindAll(const std::unordered_set<std::string>& patterns, const std::string& text)
+{
+    for (const std::string& pattern : patterns) {
+        if (text.find(pattern) == std::string::npos) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// compare the automaton with std::string::find on random patterns and texts.
+static void CheckRandom(std::mt19937& random, int alphabetSize, int patternCount)
+{
+    auto randomString = [&](size_t maxSize) {
+        std::string text(random() % (maxSize + 1), '\0');
+        for (char& c : text) {
+            c = static_cast<char>(random() % alphabetSize);
+        }
+        return text;
+    };
+
+    std::unordered_set<std::string> patterns;
+    for (int i = 0; i < patternCount; ++i) {
+        patterns.insert(randomString(4));
+    }
+
+    AhoCorasick matcher(patterns);
+    for (int i = 0; i < 200; ++i) {
+        std::string text = randomString(64);
+        CHECK(matcher.MatchAny(text) == FindAny(patterns, text));
+        CHECK(matcher.MatchAll(text) == FindAll(patterns, text));
+    }
+}
+
+int main()
+{
+    // the patterns use all the 256 bytes, each byte is used twice, so a class past 255 would be taken again by the
+    // second use of the byte and collide with another byte.
+    std::unordered_set<std::string> patterns;
+    for (int c = 0; c < 256; ++c) {
+        patterns.insert(std::string(2, static_cast<char>(c)));
+    }
+
+    AhoCorasick allBytes(patterns);
+    int wrongMatches = 0;
+    for (int first = 0; first < 256; ++first) {
+        for (int second = 0; second < 256; ++second) {
+            std::string text = { static_cast<char>(first), static_cast<char>(second) };
+            wrongMatches += allBytes.MatchAny(text) != (first == second) ? 1 : 0;
+        }
+    }
+
+    CHECK(wrongMatches == 0);
+    CHECK(!allBytes.MatchAll(std::string("\xFF\xFF", 2)));
+
+    AhoCorasick lastByte({ "\xFF" });
+    CHECK(lastByte.MatchAny("abc\xFF"));
+    CHECK(!lastByte.MatchAny("abc"));
+
+    AhoCorasick empty;
+    CHECK(empty.Empty());
+    CHECK(!empty.MatchAny("abc"));
+    CHECK(empty.MatchAll("abc"));
+
+    AhoCorasick withEmptyPattern({ "", "abc" });
+    CHECK(withEmptyPattern.MatchAny("xyz"));
+    CHECK(withEmptyPattern.MatchAll("xabcx"));
+    CHECK(!withEmptyPattern.MatchAll("xyz"));
+
+    std::mt19937 random(12345);
+    for (int i = 0; i < 50; ++i) {
+        CheckRandom(random, 3, 1 + i % 8);
+        CheckRandom(random, 256, 1 + i * 10);
+    }
+
+    return g_failedChecks;
+}
@@ -0,0 +1,98 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+
+// a trivially copyable argument referring to memory owned by the caller.
+struct Name
+{
+    const char* text;
+};
+
+#ifdef HAS_STD_FORMAT
+template <>
+struct std::formatter<Name> : std::formatter<std::string_view>
+{
+    template <typename FormatContext>
+    auto format(const Name& name, FormatContext& context) const
+    {
+        return std::formatter<std::string_view>::format(name.text, context);
+    }
+};
+#else
+std::ostream& operator<<(std::ostream& os, const Name& name)
+{
+    return os << name.text;
+}
+#endif
+
+class CollectingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        logs.push_back(str);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> logs;
+};
+
+constexpr std::string_view VIEW_FORMAT = "view {}";
+
+int main()
+{
+    auto writer = std::make_shared<CollectingWriter>();
+    Log log(".", "deferred_format_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info));
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "%v");
+
+    int value = 1;
+    Name name{ "bob" };
+    void* rawPointer = &value;
+    Name* objectPointer = &name;
+    for (bool deferred : { false, true }) {
+        log.SetDeferredFormat(deferred);
+        // the format strings which are not const char*.
+        DBG_INFO(log, 0, VIEW_FORMAT, 1);
+        // the argument refers to a buffer which is changed right after the log is written.
+        std::string text = "alice";
+        DBG_INFO(log, 0, "name {} {} {}", Name{ text.c_str() }, text, 2.5);
+        text.assign("xxxxx");
+        // the pointers which are not C strings are formatted as addresses.
+        DBG_INFO(log, 0, "pointers {} {} {}", rawPointer, objectPointer, "c string");
+    }
+
+    log.Close();
+    std::string pointers = "pointers " + FORMAT("{} {}", rawPointer, static_cast<const void*>(objectPointer)) + " c string\r\n";
+    CHECK(pointers.starts_with("pointers 0x"));
+    std::vector<std::string> expected = { "view 1\r\n", "name alice alice 2.5\r\n", pointers };
+    CHECK(writer->logs.size() == 6);
+    for (size_t i = 0; i < writer->logs.size(); ++i) {
+        CHECK(writer->logs[i] == expected[i % 3]);
+    }
+
+    return g_failedChecks;
+}
@@ -0,0 +1,63 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Check.h"
+#include "FileWriter.h"
+
+using namespace simple_logger;
+
+static const std::string TEST_FILE = "file_writer_test.log";
+
+static std::string ReadFile()
+{
+    std::ifstream file(TEST_FILE, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+int main()
+{
+    std::filesystem::remove(TEST_FILE);
+    std::ofstream(TEST_FILE) << "old\n";
+
+    FileWriter writer;
+    CHECK(writer.Open(TEST_FILE));
+    CHECK(writer.Size() == 4);
+
+    writer.Append("first\n");
+    CHECK(writer.Size() == 10);
+    writer.Flush();
+    CHECK(ReadFile() == "old\nfirst\n");
+
+    // the data written by others is kept, the writer always appends at the end of the file.
+    std::ofstream(TEST_FILE, std::ios::app) << "other\n";
+    writer.Append("second\n");
+    writer.Flush();
+    CHECK(ReadFile() == "old\nfirst\nother\nsecond\n");
+
+    // the size is taken from the file when it is opened again.
+    writer.Close();
+    CHECK(writer.Open(TEST_FILE));
+    CHECK(writer.Size() == 23);
+    writer.Close();
+
+    std::filesystem::remove(TEST_FILE);
+    return g_failedChecks;
+}
@@ -0,0 +1,145 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "FlightRecorder.h"
+
+using namespace simple_logger;
+
+static const std::string TEST_FILE = "flight_recorder_test.data";
+constexpr size_t CAPACITY = 4096;
+constexpr size_t RECORD_HEADER_SIZE = 16;
+
+// the reference of the data area, it keeps the records which are not overwritten, by the file format.
+class RecorderModel
+{
+public:
+    void Write(const std::string& msg)
+    {
+        size_t length = std::min(msg.size(), CAPACITY - RECORD_HEADER_SIZE);
+        size_t recordSize = (RECORD_HEADER_SIZE + length + 7) & ~static_cast<size_t>(7);
+        if (m_pos + recordSize > CAPACITY) {
+            // the records after the padding are not read any more.
+            std::erase_if(m_records, [this](const Record& record) { return record.begin >= m_pos; });
+            m_pos = 0;
+        }
+
+        size_t end = m_pos + recordSize;
+        std::erase_if(m_records, [this, end](const Record& record) { return record.begin < end && m_pos < record.end; });
+        m_records.push_back({ m_pos, end, msg.substr(0, length) });
+        m_pos = end;
+    }
+
+    // the records from the oldest to the latest.
+    std::vector<std::string> GetRecords() const
+    {
+        std::vector<std::string> records;
+        for (const Record& record : m_records) {
+            records.push_back(record.text);
+        }
+
+        return records;
+    }
+
+private:
+    struct Record
+    {
+        size_t begin;
+        size_t end;
+        std::string text;
+    };
+
+    size_t m_pos = 0;
+    std::vector<Record> m_records;
+};
+
+static std::string MakeMessage(uint64_t sequence)
+{
+    // the lengths vary, so the padding at the end of the data area has different sizes.
+    std::string msg = "record " + std::to_string(sequence) + " ";
+    msg.append((sequence * 37) % 300, static_cast<char>('a' + sequence % 26));
+    msg.push_back('\n');
+    return msg;
+}
+
+static void CheckRecords(const RecorderModel& model)
+{
+    std::vector<std::string> records;
+    CHECK(FlightRecorder::ReadRecords(TEST_FILE, records));
+    CHECK(records == model.GetRecords());
+}
+
+int main()
+{
+    std::filesystem::remove(TEST_FILE);
+
+    FlightRecorder recorder;
+    RecorderModel model;
+    CHECK(recorder.Open(TEST_FILE, CAPACITY));
+    uint64_t sequence = 0;
+
+    // the data area is written around many times, the file is reopened and read every 97 records.
+    for (int round = 0; round < 40; ++round) {
+        for (int i = 0; i < 97; ++i, ++sequence) {
+            std::string msg = MakeMessage(sequence);
+            recorder.Write(msg);
+            model.Write(msg);
+        }
+
+        recorder.Close();
+        CheckRecords(model);
+        CHECK(recorder.Open(TEST_FILE, CAPACITY));
+    }
+
+    // the oversized record is truncated to the data area, and it is the only record left.
+    std::string oversized(CAPACITY * 2, 'x');
+    recorder.Write(oversized);
+    model.Write(oversized);
+    recorder.Close();
+    std::vector<std::string> records;
+    CHECK(FlightRecorder::ReadRecords(TEST_FILE, records));
+    CHECK(records.size() == 1 && records[0] == std::string(CAPACITY - RECORD_HEADER_SIZE, 'x'));
+    CheckRecords(model);
+
+    // the records after it overwrite it from the beginning.
+    CHECK(recorder.Open(TEST_FILE, CAPACITY));
+    for (int i = 0; i < 5; ++i, ++sequence) {
+        std::string msg = MakeMessage(sequence);
+        recorder.Write(msg);
+        model.Write(msg);
+    }
+
+    recorder.Close();
+    CheckRecords(model);
+
+    // the file of another capacity is not continued.
+    CHECK(recorder.Open(TEST_FILE, CAPACITY * 2));
+    recorder.Write("first\n");
+    recorder.Close();
+    CHECK(FlightRecorder::ReadRecords(TEST_FILE, records));
+    CHECK(records == std::vector<std::string>{ "first\n" });
+
+    // not a flight recorder file.
+    std::filesystem::resize_file(TEST_FILE, 16);
+    CHECK(!FlightRecorder::ReadRecords(TEST_FILE, records));
+
+    std::filesystem::remove(TEST_FILE);
+    return g_failedChecks;
+}
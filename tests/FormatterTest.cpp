@@ -0,0 +1,205 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include "Check.h"
+#include "Formatter.h"
+
+using namespace simple_logger;
+
+enum class Color
+{
+    Red,
+    Green,
+};
+
+// the outputs are the ones of std::format, so the checks pass with both std::format and the fallback formatter.
+static void TestIntegers()
+{
+    CHECK(FORMAT("{}", 42) == "42");
+    CHECK(FORMAT("{}", -42) == "-42");
+    CHECK(FORMAT("{}", std::numeric_limits<uint64_t>::max()) == "18446744073709551615");
+    CHECK(FORMAT("{}", std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+    CHECK(FORMAT("{}", static_cast<unsigned char>(200)) == "200");
+    CHECK(FORMAT("{}", Color::Green) == "1");
+
+    CHECK(FORMAT("{:5}", 42) == "   42");
+    CHECK(FORMAT("{:<5}", 42) == "42   ");
+    CHECK(FORMAT("{:^6}", 42) == "  42  ");
+    CHECK(FORMAT("{:*^7}", 42) == "**42***");
+    CHECK(FORMAT("{:#>4}", 7) == "###7");
+    CHECK(FORMAT("{:05}", 42) == "00042");
+    CHECK(FORMAT("{:05}", -42) == "-0042");
+    CHECK(FORMAT("{:<05}", 42) == "42   ");
+    CHECK(FORMAT("{:2}", 12345) == "12345");
+
+    CHECK(FORMAT("{:x}", 255) == "ff");
+    CHECK(FORMAT("{:X}", 255) == "FF");
+    CHECK(FORMAT("{:x}", -255) == "-ff");
+    CHECK(FORMAT("{:08x}", 0xbeefu) == "0000beef");
+    CHECK(FORMAT("{:o}", 8) == "10");
+    CHECK(FORMAT("{:b}", 5) == "101");
+    CHECK(FORMAT("{:B}", 5) == "101");
+    CHECK(FORMAT("{:08b}", 5) == "00000101");
+    CHECK(FORMAT("{:d}", 17) == "17");
+    CHECK(FORMAT("{:b}", std::numeric_limits<uint64_t>::max()) == std::string(64, '1'));
+}
+
+static void TestFloatingPoints()
+{
+    CHECK(FORMAT("{}", 0.1) == "0.1");
+    CHECK(FORMAT("{}", 0.1f) == "0.1");
+    CHECK(FORMAT("{}", 1.5L) == "1.5");
+    CHECK(FORMAT("{}", 1e20) == "1e+20");
+    CHECK(FORMAT("{}", -2.5) == "-2.5");
+
+    CHECK(FORMAT("{:.2f}", 3.14159) == "3.14");
+    CHECK(FORMAT("{:8.3f}", 3.14159) == "   3.142");
+    CHECK(FORMAT("{:<8.3f}", 3.14159) == "3.142   ");
+    CHECK(FORMAT("{:08.2f}", -3.14159) == "-0003.14");
+    CHECK(FORMAT("{:f}", 1.5) == "1.500000");
+    CHECK(FORMAT("{:.0f}", 2.5) == "2");
+    CHECK(FORMAT("{:.1f}", 1e300).size() == 303);
+    CHECK(FORMAT("{:e}", 1234.5) == "1.234500e+03");
+    CHECK(FORMAT("{:.2E}", 1234.5) == "1.23E+03");
+    CHECK(FORMAT("{:g}", 0.0001) == "0.0001");
+    CHECK(FORMAT("{:g}", 1e-5) == "1e-05");
+    CHECK(FORMAT("{:G}", 1e-5) == "1E-05");
+    CHECK(FORMAT("{:.3g}", 1234.5) == "1.23e+03");
+    CHECK(FORMAT("{:.3}", 1234.5) == "1.23e+03");
+
+    // inf and nan are padded with spaces even if the zero padding is asked.
+    double inf = std::numeric_limits<double>::infinity();
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    CHECK(FORMAT("{}", inf) == "inf");
+    CHECK(FORMAT("{}", -inf) == "-inf");
+    CHECK(FORMAT("{}", nan) == "nan");
+    CHECK(FORMAT("{:F}", inf) == "INF");
+    CHECK(FORMAT("{:E}", nan) == "NAN");
+    CHECK(FORMAT("{:05}", -inf) == " -inf");
+    CHECK(FORMAT("{:06}", inf) == "   inf");
+    CHECK(FORMAT("{:06.2f}", nan) == "   nan");
+    CHECK(FORMAT("{:<6}", -inf) == "-inf  ");
+    CHECK(FORMAT("{:*^7}", inf) == "**inf**");
+}
+
+static void TestOthers()
+{
+    CHECK(FORMAT("{}", "abc") == "abc");
+    CHECK(FORMAT("{}", std::string("abc")) == "abc");
+    CHECK(FORMAT("{:6}", "abc") == "abc   ");
+    CHECK(FORMAT("{:>6}", "abc") == "   abc");
+    CHECK(FORMAT("{:^7}", "abc") == "  abc  ");
+    CHECK(FORMAT("{:.2}", "abcdef") == "ab");
+    CHECK(FORMAT("{:-^7.2}", "abcdef") == "--ab---");
+    CHECK(FORMAT("{:s}", "abc") == "abc");
+
+    CHECK(FORMAT("{}", true) == "true");
+    CHECK(FORMAT("{:>6}", false) == " false");
+    CHECK(FORMAT("{:d}", true) == "1");
+    CHECK(FORMAT("{:s}", false) == "false");
+
+    CHECK(FORMAT("{}", 'a') == "a");
+    CHECK(FORMAT("{:3}", 'a') == "a  ");
+    CHECK(FORMAT("{:d}", 'a') == "97");
+    CHECK(FORMAT("{:x}", 'a') == "61");
+
+    CHECK(FORMAT("{}", nullptr) == "0x0");
+    CHECK(FORMAT("{}", reinterpret_cast<const void*>(0x1234)) == "0x1234");
+
+    CHECK(FORMAT("no arguments") == "no arguments");
+    CHECK(FORMAT("{{}}") == "{}");
+    CHECK(FORMAT("{{{}}}", 1) == "{1}");
+    CHECK(FORMAT("a{}b{}c{}", 1, "two", 3.5) == "a1btwoc3.5");
+}
+
+#ifndef HAS_STD_FORMAT
+struct Point
+{
+    int x;
+    int y;
+};
+
+static std::ostream& operator<<(std::ostream& os, const Point& point)
+{
+    return os << '(' << point.x << ", " << point.y << ')';
+}
+
+// return the error thrown by AppendVFormat, or an empty string if it succeeds.
+template <typename... Args>
+static std::string GetVFormatError(std::string_view fmt, Args&&... args)
+{
+    std::string out;
+    try {
+        AppendVFormat(out, fmt, args...);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+
+    return "";
+}
+
+// the features of the fallback formatter only.
+static void TestFallback()
+{
+    CHECK(FORMAT("{}", Point{ 1, 2 }) == "(1, 2)");
+    CHECK(FORMAT("{:8}", Point{ 1, 2 }) == "(1, 2)  ");
+    CHECK(FORMAT("{:>8}", Point{ 1, 2 }) == "  (1, 2)");
+    CHECK(FORMAT("p={} n={}", Point{ -1, 0 }, 7) == "p=(-1, 0) n=7");
+
+    std::string out = "x";
+    AppendFormat(out, "{:>4}", 7);
+    AppendVFormat(out, "|{}|{:.1f}", "a", 0.25);
+    CHECK(out == "x   7|a|0.2");
+
+    CHECK(GetVFormatError("{} {}", 1, 2).empty());
+    CHECK(GetVFormatError("{", 1) == "Invalid formatting: unmatched '{' in format string");
+    CHECK(GetVFormatError("}", 1) == "Invalid formatting: unmatched '}' in format string");
+    CHECK(GetVFormatError("{}") == "Invalid formatting: missing arguments");
+    CHECK(GetVFormatError("{}", 1, 2) == "Invalid formatting: too many arguments are provided to format");
+    CHECK(GetVFormatError("{x}", 1) == "Invalid formatting: invalid format spec");
+    CHECK(GetVFormatError("{:.}", 1.0) == "Invalid formatting: invalid format spec");
+    CHECK(GetVFormatError("{:5x3}", 1) == "Invalid formatting: invalid format spec");
+    CHECK(GetVFormatError("{:d}", "abc") == "Invalid formatting: invalid format spec for the type of argument");
+    CHECK(GetVFormatError("{:f}", 1) == "Invalid formatting: invalid format spec for the type of argument");
+    CHECK(GetVFormatError("{:.2}", 1) == "Invalid formatting: invalid format spec for the type of argument");
+    CHECK(GetVFormatError("{:05}", "abc") == "Invalid formatting: invalid format spec for the type of argument");
+    CHECK(GetVFormatError("{:x}", Point{ 1, 2 }) == "Invalid formatting: invalid format spec for the type of argument");
+
+    // nothing is appended if the format string is invalid.
+    out = "x";
+    try {
+        AppendVFormat(out, "{} {}", 1);
+    } catch (const std::runtime_error&) {
+    }
+    CHECK(out == "x");
+}
+#endif
+
+int main()
+{
+    TestIntegers();
+    TestFloatingPoints();
+    TestOthers();
+#ifndef HAS_STD_FORMAT
+    TestFallback();
+#endif
+    return g_failedChecks;
+}
@@ -0,0 +1,180 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "Check.h"
+#include "LogEncoder.h"
+
+using namespace simple_logger;
+
+static const std::string REPLACEMENT = "\xEF\xBF\xBD";
+
+// the reference escaper, it decodes each UTF-8 sequence by the definition of the encoding.
+static std::string EscapeNaive(std::string_view text)
+{
+    std::string out;
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(static_cast<char>(c));
+            ++i;
+            continue;
+        }
+
+        if (c < 0x20) {
+            const char* shortForms[] = { "\\b", "\\t", "\\n", nullptr, "\\f", "\\r" };
+            if (c >= '\b' && c <= '\r' && shortForms[c - '\b'] != nullptr) {
+                out.append(shortForms[c - '\b']);
+            } else {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out.append(escaped);
+            }
+
+            ++i;
+            continue;
+        }
+
+        if (c < 0x80) {
+            out.push_back(static_cast<char>(c));
+            ++i;
+            continue;
+        }
+
+        size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 0;
+        uint32_t codePoint = length == 4 ? c & 0x07 : length == 3 ? c & 0x0F : c & 0x1F;
+        bool valid = length != 0 && i + length <= text.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            valid = (next & 0xC0) == 0x80;
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+
+        const uint32_t minCodePoints[] = { 0, 0, 0x80, 0x800, 0x10000 };
+        valid = valid && codePoint >= minCodePoints[length] && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+        if (valid) {
+            out.append(text.substr(i, length));
+            i += length;
+        } else {
+            out.append(REPLACEMENT);
+            ++i;
+        }
+    }
+
+    return out;
+}
+
+static std::string Escape(std::string_view text)
+{
+    std::string out;
+    AppendJsonEscaped(out, text);
+    return out;
+}
+
+static std::string EscapeScalar(std::string_view text)
+{
+    std::string out;
+    AppendJsonEscapedScalar(out, text);
+    return out;
+}
+
+// check the text at each offset of the vector chunks, the padding is plain ASCII.
+static void CheckEscape(std::string_view text, std::string_view expected)
+{
+    for (size_t offset : { 0, 1, 15, 16, 30, 31, 32, 47, 63 }) {
+        std::string padding(offset, 'a');
+        std::string input = padding + std::string(text) + padding;
+        std::string output = padding + std::string(expected) + padding;
+        CHECK(Escape(input) == output);
+        CHECK(EscapeScalar(input) == output);
+        CHECK(EscapeNaive(input) == output);
+    }
+}
+
+int main()
+{
+    // the control characters, the quotation mark and the backslash.
+    CheckEscape("\"", "\\\"");
+    CheckEscape("\\", "\\\\");
+    CheckEscape("\b\f\n\r\t", "\\b\\f\\n\\r\\t");
+    CheckEscape(std::string_view("\x00", 1), "\\u0000");
+    CheckEscape("\x01\x1f\x0b", "\\u0001\\u001f\\u000b");
+    for (int c = 0; c < 0x20; ++c) {
+        char byte = static_cast<char>(c);
+        CHECK(Escape(std::string_view(&byte, 1)) == EscapeNaive(std::string_view(&byte, 1)));
+    }
+
+    CheckEscape("\x7f /<>'", "\x7f /<>'");
+
+    // the valid sequences are kept, including the largest code point U+10FFFF.
+    CheckEscape("\xC3\xA9", "\xC3\xA9");
+    CheckEscape("\xE2\x82\xAC", "\xE2\x82\xAC");
+    CheckEscape("\xF0\x9F\x98\x80", "\xF0\x9F\x98\x80");
+    CheckEscape("\xF4\x8F\xBF\xBF", "\xF4\x8F\xBF\xBF");
+    CheckEscape("\xEF\xBF\xBF", "\xEF\xBF\xBF");
+
+    // each byte of the invalid sequences is replaced.
+    std::string two = REPLACEMENT + REPLACEMENT;
+    std::string three = two + REPLACEMENT;
+    std::string four = three + REPLACEMENT;
+    // the overlong forms.
+    CheckEscape("\xC0\xAF", two);
+    CheckEscape("\xC1\xBF", two);
+    CheckEscape("\xE0\x80\x80", three);
+    CheckEscape("\xE0\x9F\xBF", three);
+    CheckEscape("\xF0\x80\x80\x80", four);
+    CheckEscape("\xF0\x8F\xBF\xBF", four);
+    // the surrogates.
+    CheckEscape("\xED\xA0\x80", three);
+    CheckEscape("\xED\xBF\xBF", three);
+    // the truncated sequences and the lonely continuation bytes.
+    CheckEscape("\xC3", REPLACEMENT);
+    CheckEscape("\xE2\x82", two);
+    CheckEscape("\xE2\x82" "A", two + "A");
+    CheckEscape("\xF0\x9F\x98", three);
+    CheckEscape("\xF0\x9F\x98\"", three + "\\\"");
+    CheckEscape("\x80\xBF", two);
+    // the code points above U+10FFFF and the bytes never used by UTF-8.
+    CheckEscape("\xF4\x90\x80\x80", four);
+    CheckEscape("\xF5\x80\x80\x80", four);
+    CheckEscape("\xF8\x88\x80\x80\x80", four + REPLACEMENT);
+    CheckEscape("\xFE\xFF", two);
+
+    // the truncated sequences at the end of the text are not read beyond it.
+    CHECK(Escape("abc\xE2\x82") == "abc" + two);
+    CHECK(Escape("abc\xF0") == "abc" + REPLACEMENT);
+
+    // random texts of the bytes needing care, the vector scanning, the scalar scanning and the reference agree.
+    std::mt19937 random(20230323);
+    const unsigned char alphabet[] = { 'a', ' ', '"', '\\', '\n', 0x00, 0x1f, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf,
+        0xc0, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4, 0xf5, 0xff };
+    for (int round = 0; round < 20000; ++round) {
+        std::string text(random() % 100, 'a');
+        for (char& c : text) {
+            c = random() % 2 == 0 ? 'a' : static_cast<char>(alphabet[random() % sizeof(alphabet)]);
+        }
+
+        std::string expected = EscapeNaive(text);
+        CHECK(Escape(text) == expected);
+        CHECK(EscapeScalar(text) == expected);
+    }
+
+    return g_failedChecks;
+}
@@ -0,0 +1,106 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Check.h"
+#include "LogFile.h"
+
+using namespace simple_logger;
+
+static const std::filesystem::path TEST_DIR = "log_file_test_logs";
+
+static void CreateFile(const std::string& name)
+{
+    std::ofstream(TEST_DIR / name) << "old logs\n";
+}
+
+static bool Exists(const std::string& name)
+{
+    return std::filesystem::exists(TEST_DIR / name);
+}
+
+int main()
+{
+    std::filesystem::remove_all(TEST_DIR);
+    std::filesystem::create_directories(TEST_DIR);
+
+    // the segments of this log.
+    CreateFile("2024-01-01_app.log");
+    CreateFile("2024-01-01_app.log.1");
+    CreateFile("2026-10-16_app.log.2");
+    // the files of others, they look like the segments but are not.
+    const char* foreignFiles[] = { "2024-01-01_my_app.log", "notes_app.log", "2024-01-01_app.log.bak", "2024-01-01_app.log.1x",
+        "2024-01-01_app.log.", "abcd-ef-gh_app.log", "2024-1-01_app.log", "x2024-01-01_app.log", "2026-10-16_my_app.log.5",
+        "2024-01-01_app.log.1234567890123456789012" };
+    for (const char* name : foreignFiles) {
+        CreateFile(name);
+    }
+
+    {
+        LogFile file(TEST_DIR.generic_string(), "app.log");
+        file.SetRetention(1, 0);
+        file.Open("2026-10-16");
+        file.Close();
+    }
+
+    // the last segment of the date is continued and kept, the other segments are deleted by the retention.
+    CHECK(Exists("2026-10-16_app.log.2"));
+    CHECK(!Exists("2026-10-16_app.log"));
+    CHECK(!Exists("2024-01-01_app.log"));
+    CHECK(!Exists("2024-01-01_app.log.1"));
+    for (const char* name : foreignFiles) {
+        CHECK(Exists(name));
+    }
+
+    // the segments rotated within one tick of the file time tie, the older ones by their date and index are deleted.
+    // there are more than 16 of them, so std::sort does not keep the order of the directory.
+    std::filesystem::remove_all(TEST_DIR);
+    std::filesystem::create_directories(TEST_DIR);
+    auto time = std::filesystem::file_time_type::clock::now();
+    auto createSegment = [&time](const std::string& name) {
+        CreateFile(name);
+        std::filesystem::last_write_time(TEST_DIR / name, time);
+    };
+    createSegment("2026-10-14_app.log.30");
+    createSegment("2026-10-15_app.log");
+    for (int i = 31; i > 0; i -= 2) {
+        createSegment("2026-10-15_app.log." + std::to_string(i));
+        createSegment("2026-10-15_app.log." + std::to_string(i - 1 > 0 ? i - 1 : 32));
+    }
+
+    {
+        LogFile file(TEST_DIR.generic_string(), "app.log");
+        file.SetRetention(6, 0);
+        file.Open("2026-10-16");
+        file.Close();
+    }
+
+    // the current segment and the last 5 segments of the previous date are kept.
+    for (int i = 28; i <= 32; ++i) {
+        CHECK(Exists("2026-10-15_app.log." + std::to_string(i)));
+    }
+
+    for (int i = 1; i < 28; ++i) {
+        CHECK(!Exists("2026-10-15_app.log." + std::to_string(i)));
+    }
+
+    CHECK(!Exists("2026-10-15_app.log"));
+    CHECK(!Exists("2026-10-14_app.log.30"));
+
+    std::filesystem::remove_all(TEST_DIR);
+    return g_failedChecks;
+}
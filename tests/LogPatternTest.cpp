@@ -0,0 +1,186 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.h"
+#include "LogFormatter.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+
+constexpr std::string_view DATE_TIME = "2023-03-23 10:20:30.456";
+
+static LogRecord MakeRecord()
+{
+    LogRecord record;
+    record.time = GetCurrentTime();
+    record.level = LogLevel::Warn;
+    record.module = 7;
+    record.moduleName = "net";
+    record.fileName = "/src/net/Server.cpp";
+    record.line = 42;
+    record.funcName = "Accept";
+    record.threadId = 12345;
+    record.threadName = "io-worker";
+    record.message = "hello 100%";
+    return record;
+}
+
+static std::string Format(std::string_view pattern)
+{
+    std::string out = "x";
+    LogPattern(pattern).Format(MakeRecord(), DATE_TIME, out);
+    CHECK(out[0] == 'x');
+    return out.substr(1);
+}
+
+static void TestFlags()
+{
+    CHECK(Format("%Y") == "2023");
+    CHECK(Format("%m") == "03");
+    CHECK(Format("%d") == "23");
+    CHECK(Format("%H") == "10");
+    CHECK(Format("%M") == "20");
+    CHECK(Format("%S") == "30");
+    CHECK(Format("%e") == "456");
+    CHECK(Format("%l") == "Warn");
+    CHECK(Format("%L") == "W");
+    CHECK(Format("%n") == "net");
+    CHECK(Format("%N") == "7");
+    CHECK(Format("%v") == "hello 100%");
+    CHECK(Format("%s") == "Server.cpp");
+    CHECK(Format("%g") == "/src/net/Server.cpp");
+    CHECK(Format("%#") == "42");
+    CHECK(Format("%!") == "Accept");
+    CHECK(Format("%t") == "12345");
+    CHECK(Format("%w") == "io-worker");
+    CHECK(Format("%%") == "%");
+
+    LogRecord record = MakeRecord();
+    record.threadName = nullptr;
+    std::string out;
+    LogPattern("[%w]").Format(record, DATE_TIME, out);
+    CHECK(out == "[]");
+}
+
+// the date time fields are merged when the literals between them are the separators of the date time text,
+// the other literals are kept between them.
+static void TestDateTime()
+{
+    CHECK(Format("%Y-%m-%d") == "2023-03-23");
+    CHECK(Format("%Y-%m-%d %H:%M:%S.%e") == DATE_TIME);
+    CHECK(Format("%Y%m%d") == "20230323");
+    CHECK(Format("%Y/%m/%d") == "2023/03/23");
+    CHECK(Format("%Y--%m") == "2023--03");
+    CHECK(Format("%Y-x%m") == "2023-x03");
+    CHECK(Format("%d-%m-%Y") == "23-03-2023");
+    CHECK(Format("%H:%M %H:%M") == "10:20 10:20");
+    CHECK(Format("%S.%e") == "30.456");
+    CHECK(Format("%e%Y") == "4562023");
+    CHECK(Format("[%Y-%m-%d]-%H") == "[2023-03-23]-10");
+    CHECK(Format("%Y%%%m") == "2023%03");
+}
+
+static void TestLiterals()
+{
+    CHECK(Format("") == "");
+    CHECK(Format("plain text") == "plain text");
+    CHECK(Format("a%vb%vc") == "ahello 100%bhello 100%c");
+    CHECK(Format("100%% %v") == "100% hello 100%");
+
+    // the unknown flags and the trailing '%' are kept as they are.
+    CHECK(Format("%q%v") == "%qhello 100%");
+    CHECK(Format("%v%") == "hello 100%%");
+    CHECK(Format("%") == "%");
+    CHECK(Format("%%%") == "%%");
+    CHECK(Format("%Z %1 %") == "%Z %1 %");
+
+    CHECK(LogPattern("[%l] %v").GetPattern() == "[%l] %v");
+}
+
+// the patterns of the default layout produce the same bytes as the default layout.
+static void TestDefaultLayout()
+{
+    LogFormatter formatter;
+    LogRecord record = MakeRecord();
+    LogPattern detail("%Y-%m-%d %H:%M:%S.%e [%l] [%n] [%s(line: %#, method: %!, thread: %t/%w)]: %v");
+    LogPattern brief("%Y-%m-%d %H:%M:%S.%e [%l] [%n]: %v");
+    for (bool newline : { true, false }) {
+        record.newline = newline;
+        std::string layout;
+        std::string pattern;
+        formatter.Format(record, { nullptr, true, LogEncoding::Text }, layout);
+        formatter.Format(record, { &detail, true, LogEncoding::Text }, pattern);
+        CHECK(layout == pattern);
+        CHECK(layout.ends_with(newline ? "]: hello 100%\r\n" : "]: hello 100%"));
+
+        layout.clear();
+        pattern.clear();
+        formatter.Format(record, { nullptr, false, LogEncoding::Text }, layout);
+        formatter.Format(record, { &brief, false, LogEncoding::Text }, pattern);
+        CHECK(layout == pattern);
+    }
+}
+
+class CollectingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        logs.push_back(str);
+    }
+
+    std::vector<std::string> logs;
+
+private:
+    std::mutex m_mutex;
+};
+
+// the pattern set by Log::SetPattern, an empty pattern restores the default layout.
+static std::vector<std::string> WriteWithPattern(const std::string& pattern)
+{
+    auto writer = std::make_shared<CollectingWriter>();
+    Log log(".", "log_pattern_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), false);
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "[%L] %N %v");
+    log.SetPattern(OutputType::UserDefined, pattern);
+    DBG_INFO(log, 3, "log {}", 1);
+    log.Close();
+    return writer->logs;
+}
+
+static void TestSetPattern()
+{
+    CHECK(WriteWithPattern("[%L] %N %v") == std::vector<std::string>{ "[I] 3 log 1\r\n" });
+
+    std::vector<std::string> logs = WriteWithPattern("");
+    std::string_view suffix = " [Info] []: log 1\r\n";
+    CHECK(logs.size() == 1 && logs[0].size() == DATE_TIME.size() + suffix.size() && logs[0].ends_with(suffix));
+}
+
+int main()
+{
+    TestFlags();
+    TestDateTime();
+    TestLiterals();
+    TestDefaultLayout();
+    TestSetPattern();
+    return g_failedChecks;
+}
@@ -0,0 +1,258 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "LogQueue.h"
+
+using namespace simple_logger;
+
+constexpr int PRODUCER_COUNT = 4;
+constexpr uint32_t ITEMS_PER_PRODUCER = 100000;
+
+// the item carries its producer and its index in the producer.
+static uint64_t MakeItem(uint32_t producer, uint32_t index)
+{
+    return (static_cast<uint64_t>(producer) << 32) | index;
+}
+
+// pop the items pushed by the producers from queue, check each item comes once and in the order of its producer.
+static void CheckConsumedInOrder(LogQueue<uint64_t>& queue)
+{
+    std::vector<uint32_t> nextIndex(PRODUCER_COUNT, 0);
+    size_t received = 0;
+    bool ordered = true;
+    while (received < PRODUCER_COUNT * static_cast<size_t>(ITEMS_PER_PRODUCER)) {
+        uint64_t item = 0;
+        if (!queue.Pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint32_t producer = static_cast<uint32_t>(item >> 32);
+        uint32_t index = static_cast<uint32_t>(item);
+        if (producer >= PRODUCER_COUNT || index != nextIndex[producer]) {
+            ordered = false;
+            break;
+        }
+
+        ++nextIndex[producer];
+        ++received;
+    }
+
+    CHECK(ordered);
+    for (uint32_t index : nextIndex) {
+        CHECK(index == ITEMS_PER_PRODUCER);
+    }
+
+    uint64_t item = 0;
+    CHECK(!queue.Pop(item));
+    CHECK(queue.Empty());
+}
+
+static void TestRingQueueProducers()
+{
+    // the small queue is full most of the time, so the producers race for the slots.
+    RingQueue<uint64_t> queue(64);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+                uint64_t item = MakeItem(p, i);
+                while (!queue.Push(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    CheckConsumedInOrder(queue);
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+}
+
+static void TestRingQueueFull()
+{
+    RingQueue<std::unique_ptr<int>> queue(3);
+    CHECK(queue.Capacity() == 4);
+    CHECK(queue.Empty());
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.Push(std::make_unique<int>(i)));
+    }
+
+    // the item is left in place when the queue is full.
+    auto item = std::make_unique<int>(4);
+    CHECK(!queue.Push(std::move(item)));
+    CHECK(item != nullptr && *item == 4);
+
+    std::unique_ptr<int> popped;
+    CHECK(queue.Pop(popped) && *popped == 0);
+    CHECK(queue.Push(std::move(item)));
+    CHECK(item == nullptr);
+
+    std::vector<std::unique_ptr<int>> items;
+    CHECK(queue.PopBatch(items, 10) == 4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(*items[i] == i + 1);
+    }
+
+    CHECK(queue.Empty());
+    CHECK(!queue.Pop(popped));
+}
+
+static void TestSpscQueueFull()
+{
+    SpscQueue<int> queue(4);
+    CHECK(queue.Empty());
+    CHECK(queue.Front() == nullptr);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.Emplace(i));
+    }
+
+    CHECK(!queue.Emplace(4));
+    CHECK(!queue.Empty());
+    CHECK(queue.Front() != nullptr && *queue.Front() == 0);
+    queue.PopFront();
+    CHECK(queue.Emplace(4));
+    for (int i = 1; i <= 4; ++i) {
+        int* item = queue.Front();
+        CHECK(item != nullptr && *item == i);
+        queue.PopFront();
+    }
+
+    CHECK(queue.Empty());
+    CHECK(queue.Front() == nullptr);
+}
+
+static void TestThreadLocalQueueFull()
+{
+    ThreadLocalQueue<std::unique_ptr<int>> queue(4, false);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.Push(std::make_unique<int>(i)));
+    }
+
+    // the buffer of the thread is full, the item is left in place.
+    auto item = std::make_unique<int>(4);
+    CHECK(!queue.Push(std::move(item)));
+    CHECK(item != nullptr && *item == 4);
+
+    // the buffer of another thread is not full.
+    std::thread([&queue] { CHECK(queue.Push(std::make_unique<int>(10))); }).join();
+
+    std::vector<std::unique_ptr<int>> items;
+    CHECK(queue.PopBatch(items, 10) == 5);
+    CHECK(queue.Empty());
+    CHECK(queue.Push(std::move(item)));
+    CHECK(!queue.Empty());
+}
+
+// the threads push in turns, so the order of the items is the order of their pushing time.
+static void TestThreadLocalQueueOrdered()
+{
+    constexpr uint32_t ITEM_COUNT = 3000;
+    ThreadLocalQueue<uint64_t> queue(ITEM_COUNT, true);
+    std::atomic<uint32_t> turn = 0;
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back([&queue, &turn, p] {
+            for (uint32_t i = p; i < ITEM_COUNT; i += PRODUCER_COUNT) {
+                while (turn.load(std::memory_order_acquire) != i) {
+                    std::this_thread::yield();
+                }
+
+                CHECK(queue.Push(MakeItem(p, i)));
+                turn.store(i + 1, std::memory_order_release);
+            }
+        });
+    }
+
+    // the producers have exited, their buffers are closed and still drained.
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    CHECK(!queue.Empty());
+    bool ordered = true;
+    for (uint32_t i = 0; i < ITEM_COUNT; ++i) {
+        uint64_t item = 0;
+        if (!queue.Pop(item) || item != MakeItem(i % PRODUCER_COUNT, i)) {
+            ordered = false;
+            break;
+        }
+    }
+
+    CHECK(ordered);
+    uint64_t item = 0;
+    CHECK(!queue.Pop(item));
+    CHECK(queue.Empty());
+}
+
+// the items of each thread keep their order in round robin, including the ones left by the exited threads.
+static void TestThreadLocalQueueRoundRobin()
+{
+    ThreadLocalQueue<uint64_t> queue(64, false);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+                uint64_t item = MakeItem(p, i);
+                while (!queue.Push(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    CheckConsumedInOrder(queue);
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    // the buffers of the exited threads are dropped, the buffers of the new threads are picked up.
+    std::thread([&queue] { CHECK(queue.Push(MakeItem(1, 7))); }).join();
+    uint64_t item = 0;
+    CHECK(queue.Pop(item) && item == MakeItem(1, 7));
+    CHECK(queue.Empty());
+}
+
+// the buffer of a destroyed queue is dropped by its thread, and the thread can push to another queue.
+static void TestThreadLocalQueueDestroyed()
+{
+    auto first = std::make_unique<ThreadLocalQueue<uint64_t>>(4, false);
+    CHECK(first->Push(1));
+    first.reset();
+
+    ThreadLocalQueue<uint64_t> second(4, false);
+    CHECK(second.Push(2));
+    uint64_t item = 0;
+    CHECK(second.Pop(item) && item == 2);
+}
+
+int main()
+{
+    TestRingQueueProducers();
+    TestRingQueueFull();
+    TestSpscQueueFull();
+    TestThreadLocalQueueFull();
+    TestThreadLocalQueueOrdered();
+    TestThreadLocalQueueRoundRobin();
+    TestThreadLocalQueueDestroyed();
+    return g_failedChecks;
+}
@@ -0,0 +1,121 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+
+constexpr int NET = 3;
+constexpr int DB = 4;
+
+class CollectingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        logs.push_back(str.substr(0, str.find_last_not_of("\r\n") + 1));
+    }
+
+    std::vector<std::string> logs;
+
+private:
+    std::mutex m_mutex;
+};
+
+static void TestNeedWrite(Log& log)
+{
+    uint32_t global = MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Fatal);
+    uint32_t debugOnly = MakeFlag(LogLevel::Debug);
+    CHECK(log.GetModuleLevelFlag(NET) == global);
+
+    log.SetModuleLevelFlag(NET, debugOnly);
+    CHECK(log.GetModuleLevelFlag(NET) == debugOnly);
+    CHECK(log.NeedWrite(LogLevel::Debug, NET));
+    CHECK(!log.NeedWrite(LogLevel::Info, NET));
+    CHECK(!log.NeedWrite(LogLevel::Error, NET));
+
+    // the other modules still follow the global level flag.
+    CHECK(log.GetModuleLevelFlag(DB) == global);
+    CHECK(!log.NeedWrite(LogLevel::Debug, DB));
+    CHECK(log.NeedWrite(LogLevel::Info, DB));
+    CHECK(log.NeedWrite(LogLevel::Error, 0));
+
+    // the module level flag is kept when the global one changes.
+    log.SetLogSwitchOff(LogLevel::Info);
+    CHECK(!log.NeedWrite(LogLevel::Info, DB));
+    CHECK(log.NeedWrite(LogLevel::Debug, NET));
+    log.SetLogSwitchOn(LogLevel::Info);
+
+    // the modules out of [0, MAX_MODULE_NUM) have no level flag of their own, they follow the global level flag.
+    for (int module : { MAX_MODULE_NUM, MAX_MODULE_NUM + 1, 100000, -1 }) {
+        log.SetModuleLevelFlag(module, debugOnly);
+        CHECK(log.GetModuleLevelFlag(module) == global);
+        CHECK(!log.NeedWrite(LogLevel::Debug, module));
+        CHECK(log.NeedWrite(LogLevel::Info, module));
+        log.ClearModuleLevelFlag(module);
+    }
+
+    // the last module in the table.
+    log.SetModuleLevelFlag(MAX_MODULE_NUM - 1, debugOnly);
+    CHECK(log.NeedWrite(LogLevel::Debug, MAX_MODULE_NUM - 1));
+    CHECK(!log.NeedWrite(LogLevel::Info, MAX_MODULE_NUM - 1));
+
+    log.ClearModuleLevelFlag(NET);
+    CHECK(log.GetModuleLevelFlag(NET) == global);
+    CHECK(!log.NeedWrite(LogLevel::Debug, NET));
+    CHECK(log.NeedWrite(LogLevel::Info, NET));
+    CHECK(log.NeedWrite(LogLevel::Debug, MAX_MODULE_NUM - 1));
+
+    log.SetModuleLevelFlag(NET, debugOnly);
+    log.SetModuleLevelFlag(DB, debugOnly);
+    log.ClearAllModuleLevelFlag();
+    CHECK(log.GetModuleLevelFlag(NET) == global);
+    CHECK(log.GetModuleLevelFlag(DB) == global);
+    CHECK(log.GetModuleLevelFlag(MAX_MODULE_NUM - 1) == global);
+    CHECK(!log.NeedWrite(LogLevel::Debug, MAX_MODULE_NUM - 1));
+}
+
+// the print micros drop the logs by the level flag of their module.
+static void TestWrite(Log& log, const std::shared_ptr<CollectingWriter>& writer)
+{
+    log.SetModuleLevelFlag(NET, MakeFlag(LogLevel::Debug, LogLevel::Error));
+    for (int module : { NET, DB, MAX_MODULE_NUM, -1 }) {
+        DBG_DEBUG(log, module, "debug {}", module);
+        DBG_INFO(log, module, "info {}", module);
+        DBG_ERROR(log, module, "error {}", module);
+    }
+
+    log.Close();
+    std::vector<std::string> expected = { "debug 3", "error 3", "info 4", "error 4", "info 256", "error 256", "info -1", "error -1" };
+    CHECK(writer->logs == expected);
+}
+
+int main()
+{
+    auto writer = std::make_shared<CollectingWriter>();
+    Log log(".", "module_level_test", MakeFlag(OutputType::UserDefined));
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "%v");
+
+    TestNeedWrite(log);
+    TestWrite(log, writer);
+    return g_failedChecks;
+}
@@ -0,0 +1,275 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef linux
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "Check.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+using namespace std::chrono_literals;
+
+// the writer holds the first log until it is released, so the logs after it stay in the log queue.
+class GatedWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::string log = str;
+        while (!log.empty() && (log.back() == '\n' || log.back() == '\r')) {
+            log.pop_back();
+        }
+
+        logs.push_back(log);
+        started = true;
+        m_cond.wait(lock, [this] { return m_released; });
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_released = true;
+        m_cond.notify_all();
+    }
+
+    std::vector<std::string> logs;
+    std::atomic<bool> started = false;
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_released = false;
+};
+
+static bool WaitUntil(const std::function<bool()>& done)
+{
+    for (int i = 0; i < 5000 && !done(); ++i) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    return done();
+}
+
+// a log whose writer thread is stalled, the logs written after Stall stay in the log queue until Release.
+class StalledLog
+{
+public:
+    explicit StalledLog(QueueType queueType)
+        : log(".", "overflow_policy_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info, LogLevel::Warn, LogLevel::Error), true, queueType),
+        m_writer(std::make_shared<GatedWriter>())
+    {
+        log.SetUserWriter(m_writer);
+        log.SetPattern(OutputType::UserDefined, "%v");
+        // the user writer holds the first gate, the second gate fills its queue, and the log writer thread is
+        // blocked by handing the third gate to it.
+        log.SetSinkQueueLimit(OutputType::UserDefined, 1, OverflowPolicy::Block);
+        DBG_INFO(log, 0, "gate");
+        CHECK(WaitUntil([this] { return m_writer->started.load(); }));
+        for (int i = 0; i < 2; ++i) {
+            DBG_INFO(log, 0, "gate");
+            CHECK(WaitUntil([this] { return log.IsLogQueEmpty(); }));
+        }
+
+        std::this_thread::sleep_for(50ms);
+    }
+
+    void Release()
+    {
+        m_writer->Release();
+    }
+
+    // the logs written after the gates.
+    std::vector<std::string> Finish()
+    {
+        Release();
+        log.Close();
+        CHECK(m_writer->logs.size() >= 3);
+        return std::vector<std::string>(m_writer->logs.begin() + 3, m_writer->logs.end());
+    }
+
+    Log log;
+
+private:
+    std::shared_ptr<GatedWriter> m_writer;
+};
+
+static void WriteLogs(Log& log, int count, LogLevel level = LogLevel::Info)
+{
+    for (int i = 0; i < count; ++i) {
+        DBG_WRITE(log, level, 0, "log {}", i);
+    }
+}
+
+static std::string DroppedReport(int count)
+{
+    return std::to_string(count) + " logs are dropped because the log queue is full";
+}
+
+static void TestDropNewest()
+{
+    StalledLog stalled(QueueType::Locked);
+    stalled.log.SetQueueLimit(4, 0);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::DropNewest);
+    WriteLogs(stalled.log, 10);
+    CHECK(stalled.log.GetDroppedCount() == 6);
+
+    // the space of the written logs is given back, so the logs after them are not dropped.
+    stalled.Release();
+    CHECK(WaitUntil([&stalled] { return stalled.log.IsLogQueEmpty(); }));
+    std::this_thread::sleep_for(50ms);
+    for (int i = 0; i < 4; ++i) {
+        DBG_INFO(stalled.log, 0, "after {}", i);
+    }
+
+    CHECK(stalled.log.GetDroppedCount() == 6);
+    std::vector<std::string> expected = { "log 0", "log 1", "log 2", "log 3", DroppedReport(6), "after 0", "after 1", "after 2", "after 3" };
+    CHECK(stalled.Finish() == expected);
+}
+
+static void TestDropOldest()
+{
+    StalledLog stalled(QueueType::Locked);
+    stalled.log.SetQueueLimit(4, 0);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::DropOldest);
+    WriteLogs(stalled.log, 10);
+    CHECK(stalled.log.GetDroppedCount() == 6);
+    std::vector<std::string> expected = { "log 6", "log 7", "log 8", "log 9", DroppedReport(6) };
+    CHECK(stalled.Finish() == expected);
+}
+
+// the thread local queues are popped by the log writer thread only, so DropOldest works as DropNewest.
+static void TestDropOldestThreadLocal()
+{
+    StalledLog stalled(QueueType::ThreadLocal);
+    stalled.log.SetQueueLimit(4, 0);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::DropOldest);
+    WriteLogs(stalled.log, 10);
+    CHECK(stalled.log.GetDroppedCount() == 6);
+    std::vector<std::string> expected = { "log 0", "log 1", "log 2", "log 3", DroppedReport(6) };
+    CHECK(stalled.Finish() == expected);
+}
+
+// the bytes of the messages are limited, a log larger than the limit is still taken by the empty queue.
+static void TestByteLimit()
+{
+    StalledLog stalled(QueueType::Locked);
+    stalled.log.SetQueueLimit(0, 100);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::DropNewest);
+    std::string large(150, 'x');
+    DBG_INFO(stalled.log, 0, "{}", large);
+    DBG_INFO(stalled.log, 0, "small");
+    CHECK(stalled.log.GetDroppedCount() == 1);
+
+    std::vector<std::string> expected = { large, DroppedReport(1) };
+    CHECK(stalled.Finish() == expected);
+
+    StalledLog counted(QueueType::Locked);
+    counted.log.SetQueueLimit(0, 100);
+    counted.log.SetOverflowPolicy(OverflowPolicy::DropNewest);
+    std::string text(40, 'y');
+    for (int i = 0; i < 3; ++i) {
+        DBG_INFO(counted.log, 0, "{}", text);
+    }
+
+    CHECK(counted.log.GetDroppedCount() == 1);
+    expected = { text, text, DroppedReport(1) };
+    CHECK(counted.Finish() == expected);
+}
+
+// the thread waits for the space without using the CPU, return the CPU time it used.
+static std::chrono::milliseconds GetThreadCpuTime([[maybe_unused]] std::thread& thread)
+{
+#ifdef linux
+    clockid_t clock;
+    timespec time;
+    if (pthread_getcpuclockid(thread.native_handle(), &clock) == 0 && clock_gettime(clock, &time) == 0) {
+        return std::chrono::seconds(time.tv_sec) + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(time.tv_nsec));
+    }
+#endif
+    return 0ms;
+}
+
+static void TestBlock()
+{
+    StalledLog stalled(QueueType::Locked);
+    stalled.log.SetQueueLimit(4, 0);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::Block);
+    WriteLogs(stalled.log, 4);
+
+    std::atomic<bool> written = false;
+    std::thread blocked([&stalled, &written] {
+        DBG_INFO(stalled.log, 0, "blocked");
+        written = true;
+    });
+
+    std::this_thread::sleep_for(300ms);
+    CHECK(!written);
+    CHECK(GetThreadCpuTime(blocked) < 100ms);
+
+    stalled.Release();
+    blocked.join();
+    CHECK(stalled.log.GetDroppedCount() == 0);
+    std::vector<std::string> expected = { "log 0", "log 1", "log 2", "log 3", "blocked" };
+    CHECK(stalled.Finish() == expected);
+}
+
+// the logs below the drop level are dropped, the others wait for the space.
+static void TestDropBelowLevel()
+{
+    StalledLog stalled(QueueType::Locked);
+    stalled.log.SetQueueLimit(4, 0);
+    stalled.log.SetOverflowPolicy(OverflowPolicy::DropBelowLevel, LogLevel::Warn);
+    WriteLogs(stalled.log, 6);
+    CHECK(stalled.log.GetDroppedCount() == 2);
+
+    std::atomic<bool> written = false;
+    std::thread blocked([&stalled, &written] {
+        DBG_ERROR(stalled.log, 0, "error");
+        written = true;
+    });
+
+    std::this_thread::sleep_for(100ms);
+    CHECK(!written);
+
+    stalled.Release();
+    blocked.join();
+    CHECK(stalled.log.GetDroppedCount() == 2);
+    std::vector<std::string> expected = { "log 0", "log 1", "log 2", "log 3", DroppedReport(2), "error" };
+    CHECK(stalled.Finish() == expected);
+}
+
+int main()
+{
+    TestDropNewest();
+    TestDropOldest();
+    TestDropOldestThreadLocal();
+    TestByteLimit();
+    TestBlock();
+    TestDropBelowLevel();
+    return g_failedChecks;
+}
@@ -0,0 +1,166 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "Logger.h"
+
+using namespace simple_logger;
+
+// it holds the writing until it is opened, so the logs after the first one stay in the queues unformatted.
+class CollectingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered = true;
+        cond.notify_all();
+        cond.wait(lock, [this] { return opened; });
+        logs.push_back(str);
+    }
+
+    void WaitEntered()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this] { return entered; });
+    }
+
+    void Open()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        cond.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool entered = false;
+    bool opened = false;
+    std::vector<std::string> logs;
+};
+
+class CountingWriter : public UserDefinedWriter
+{
+public:
+    void Write(const std::string& str) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        logs.push_back(str);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> logs;
+};
+
+// the names cached by the thread are checked by their text, the buffer at the same address may hold another name.
+static void TestReusedBuffer()
+{
+    auto writer = std::make_shared<CountingWriter>();
+    Log log(".", "source_name_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), true);
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "%s %! %v");
+
+    char fileName[32];
+    char funcName[32];
+    for (int i = 0; i < 6; ++i) {
+        snprintf(fileName, sizeof(fileName), "/src/reused_%d.cpp", i % 2);
+        snprintf(funcName, sizeof(funcName), "Func%d", i % 3);
+        log.Write(LogLevel::Info, 0, fileName, i, funcName, std::this_thread::get_id(), std::to_string(i));
+    }
+
+    log.Close();
+    std::vector<std::string> expected;
+    for (int i = 0; i < 6; ++i) {
+        expected.push_back("reused_" + std::to_string(i % 2) + ".cpp Func" + std::to_string(i % 3) + " " + std::to_string(i) + "\r\n");
+    }
+
+    CHECK(writer->logs == expected);
+}
+
+// the pool of the names stops growing, the names after it are replaced, the names in it are still written.
+static void TestTooManyNames()
+{
+    constexpr int MAX_NAME_NUM = 65536;
+    auto writer = std::make_shared<CountingWriter>();
+    Log log(".", "source_name_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), true);
+    log.SetUserWriter(writer);
+    log.SetPattern(OutputType::UserDefined, "%s");
+
+    for (int i = 0; i < MAX_NAME_NUM + 2; ++i) {
+        std::string fileName = "f" + std::to_string(i);
+        log.Write(LogLevel::Info, 0, fileName.c_str(), 0, "Func", std::this_thread::get_id(), "");
+    }
+
+    std::string first = "f0";
+    log.Write(LogLevel::Info, 0, first.c_str(), 0, "Func", std::this_thread::get_id(), "");
+    log.Close();
+
+    CHECK(writer->logs.size() == MAX_NAME_NUM + 3);
+    if (writer->logs.size() == MAX_NAME_NUM + 3) {
+        // "Func" is the first name in the pool.
+        CHECK(writer->logs[MAX_NAME_NUM - 2] == "f" + std::to_string(MAX_NAME_NUM - 2) + "\r\n");
+        CHECK(writer->logs[MAX_NAME_NUM - 1] == "(too many source names)\r\n");
+        CHECK(writer->logs[MAX_NAME_NUM + 1] == "(too many source names)\r\n");
+        CHECK(writer->logs.back() == "f0\r\n");
+    }
+}
+
+int main()
+{
+    auto writer = std::make_shared<CollectingWriter>();
+    std::shared_ptr<UserDefinedWriter> userWriter = writer;
+    Log log(".", "source_name_test", MakeFlag(OutputType::UserDefined), MakeFlag(LogLevel::Info), true);
+    log.SetUserWriter(userWriter);
+
+    DBG_INFO(log, 0, "first");
+    writer->WaitEntered();
+
+    // the names live in buffers which are overwritten before the logs are written.
+    std::vector<std::string> fileNames;
+    std::vector<std::string> funcNames(100, "GeneratedFunction");
+    for (int i = 0; i < 100; ++i) {
+        fileNames.push_back("/src/generated_" + std::to_string(i % 3) + ".cpp");
+        log.Write(LogLevel::Info, 0, fileNames[i].c_str(), i, funcNames[i].c_str(), std::this_thread::get_id(), "message " + std::to_string(i));
+    }
+
+    log.Write(LogLevel::Info, 0, nullptr, 0, nullptr, std::this_thread::get_id(), "no source");
+    for (int i = 0; i < 100; ++i) {
+        fileNames[i].assign(fileNames[i].size(), 'x');
+        funcNames[i].assign(funcNames[i].size(), 'y');
+    }
+
+    writer->Open();
+    log.Close();
+
+    CHECK(writer->logs.size() == 102);
+    for (size_t i = 0; i < 100 && i + 1 < writer->logs.size(); ++i) {
+        const std::string& text = writer->logs[i + 1];
+        CHECK(text.find("generated_" + std::to_string(i % 3) + ".cpp(line: " + std::to_string(i) + ", method: GeneratedFunction") != std::string::npos);
+        CHECK(text.find("message " + std::to_string(i)) != std::string::npos);
+    }
+
+    CHECK(writer->logs.size() == 102 && writer->logs.back().find("no source") != std::string::npos);
+
+    TestReusedBuffer();
+    TestTooManyNames();
+    return g_failedChecks;
+}
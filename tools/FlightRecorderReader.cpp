@@ -0,0 +1,42 @@
+// Copyright(c) 2023-present, Dreams Chen.
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "FlightRecorder.h"
+
+// print the logs in a flight recorder file from the oldest to the latest.
+// usage: flight_recorder_reader <file>
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <flight recorder file>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> records;
+    if (!simple_logger::FlightRecorder::ReadRecords(argv[1], records)) {
+        std::cerr << argv[1] << " is not a flight recorder file" << std::endl;
+        return 1;
+    }
+
+    for (const std::string& record : records) {
+        std::cout.write(record.data(), record.size());
+    }
+
+    std::cout.flush();
+    return 0;
+}